@@ -49,6 +49,9 @@ endif
 include common_features.mk
 include $(TMK_PATH)/common.mk
 include $(QUANTUM_PATH)/serial_link/tests/rules.mk
+include $(DRIVER_PATH)/arm/tests/rules.mk
+include $(DRIVER_PATH)/i2c_queue/tests/rules.mk
+include $(QUANTUM_PATH)/audio/tests/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include build_full_test.mk
 endif
@@ -30,6 +30,8 @@ endif
 
 MUSIC_ENABLE := 0
 
+VALID_AUDIO_DRIVER_TYPES := dac wavetable
+AUDIO_DRIVER ?= dac
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     OPT_DEFS += -DAUDIO_ENABLE
     MUSIC_ENABLE := 1
@@ -38,7 +40,17 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),AVR)
         SRC += $(QUANTUM_DIR)/audio/audio.c
     else
-        SRC += $(QUANTUM_DIR)/audio/audio_arm.c
+        ifeq ($(filter $(AUDIO_DRIVER),$(VALID_AUDIO_DRIVER_TYPES)),)
+            $(error AUDIO_DRIVER="$(AUDIO_DRIVER)" is not a valid audio driver)
+        endif
+        ifeq ($(strip $(AUDIO_DRIVER)), wavetable)
+            OPT_DEFS += -DAUDIO_DRIVER_WAVETABLE
+            SRC += $(QUANTUM_DIR)/audio/audio_wavetable.c
+            SRC += $(QUANTUM_DIR)/audio/wavetable.c
+        else
+            SRC += $(QUANTUM_DIR)/audio/audio_arm.c
+        endif
+        SRC += $(QUANTUM_DIR)/audio/audio_benchmark.c
     endif
     SRC += $(QUANTUM_DIR)/audio/voices.c
     SRC += $(QUANTUM_DIR)/audio/luts.c
@@ -341,6 +353,9 @@ ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
     ifeq ($(strip $(WS2812_DRIVER)), i2c)
         QUANTUM_LIB_SRC += i2c_master.c
     endif
+    ifeq ($(strip $(WS2812_DRIVER)), spi)
+        SRC += ws2812_encode.c
+    endif
 endif
 
 ifeq ($(strip $(CIE1931_CURVE)), yes)
@@ -482,6 +497,24 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
 
+VALID_I2C_QUEUE_DRIVER_TYPES := master custom
+
+I2C_QUEUE_ENABLE ?= no
+ifeq ($(strip $(I2C_QUEUE_ENABLE)), yes)
+    I2C_QUEUE_DRIVER ?= master
+    ifeq ($(filter $(I2C_QUEUE_DRIVER),$(VALID_I2C_QUEUE_DRIVER_TYPES)),)
+        $(error I2C_QUEUE_DRIVER="$(I2C_QUEUE_DRIVER)" is not a valid I2C queue driver)
+    endif
+
+    OPT_DEFS += -DI2C_QUEUE_ENABLE
+    COMMON_VPATH += $(DRIVER_PATH)/i2c_queue
+    QUANTUM_LIB_SRC += i2c_master.c
+    SRC += i2c_queue.c
+    ifneq ($(strip $(I2C_QUEUE_DRIVER)), custom)
+        SRC += i2c_queue_$(strip $(I2C_QUEUE_DRIVER)).c
+    endif
+endif
+
 ifeq ($(strip $(OLED_DRIVER_ENABLE)), yes)
     OPT_DEFS += -DOLED_DRIVER_ENABLE
     COMMON_VPATH += $(DRIVER_PATH)/oled
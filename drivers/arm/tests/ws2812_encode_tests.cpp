@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include <string>
+extern "C" {
+#include "arm/ws2812_encode.h"
+}
+
+// The SPI bits sent for the given bytes, as a string of 0s and 1s
+static std::string waveform(const uint8_t* data, size_t size) {
+    std::string bits;
+    for (size_t i = 0; i < size; i++) {
+        for (int8_t bit = 7; bit >= 0; bit--) {
+            bits += (data[i] >> bit) & 1 ? '1' : '0';
+        }
+    }
+    return bits;
+}
+
+// Decodes a waveform the way the LED does, a long high pulse is a one
+static bool decode(const std::string& bits, std::string* out) {
+    for (size_t i = 0; i + 4 <= bits.size(); i += 4) {
+        std::string symbol = bits.substr(i, 4);
+        if (symbol == "1110") {
+            *out += '1';
+        } else if (symbol == "1000") {
+            *out += '0';
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string byte_bits(uint8_t value) {
+    std::string bits;
+    for (int8_t bit = 7; bit >= 0; bit--) {
+        bits += (value >> bit) & 1 ? '1' : '0';
+    }
+    return bits;
+}
+
+class WS2812Encode : public testing::Test {};
+
+TEST_F(WS2812Encode, encodes_a_led_in_grb_order) {
+    LED_TYPE led = {};
+    led.r        = 0x00;
+    led.g        = 0xFF;
+    led.b        = 0xA5;
+    uint8_t out[WS2812_SPI_BYTES_PER_LED];
+    ws2812_encode_spi(out, &led, 1);
+    std::string expected =
+        // g = 0xFF
+        "1110111011101110"
+        "1110111011101110"
+        // r = 0x00
+        "1000100010001000"
+        "1000100010001000"
+        // b = 0xA5
+        "1110100011101000"
+        "1000111010001110";
+#ifdef RGBW
+    expected += "1000100010001000"
+                "1000100010001000";
+#endif
+    EXPECT_EQ(waveform(out, sizeof(out)), expected);
+}
+
+TEST_F(WS2812Encode, every_value_decodes_back) {
+    for (uint16_t value = 0; value < 256; value++) {
+        LED_TYPE led = {};
+        led.r        = value;
+        led.g        = ~value;
+        led.b        = value ^ 0x5A;
+        uint8_t out[WS2812_SPI_BYTES_PER_LED];
+        ws2812_encode_spi(out, &led, 1);
+        std::string bits;
+        EXPECT_TRUE(decode(waveform(out, sizeof(out)), &bits)) << "value " << value;
+        EXPECT_EQ(bits.substr(0, 24), byte_bits(led.g) + byte_bits(led.r) + byte_bits(led.b)) << "value " << value;
+    }
+}
+
+TEST_F(WS2812Encode, packs_leds_back_to_back) {
+    LED_TYPE leds[3] = {};
+    for (uint8_t i = 0; i < 3; i++) {
+        leds[i].r = 0x10 * i;
+        leds[i].g = 0x01 << i;
+        leds[i].b = 0xF0 >> i;
+    }
+    uint8_t out[WS2812_SPI_BYTES_PER_LED * 3 + 1];
+    out[sizeof(out) - 1] = 0x42;
+    ws2812_encode_spi(out, leds, 3);
+    EXPECT_EQ(out[sizeof(out) - 1], 0x42);
+    for (uint8_t i = 0; i < 3; i++) {
+        uint8_t single[WS2812_SPI_BYTES_PER_LED];
+        ws2812_encode_spi(single, &leds[i], 1);
+        EXPECT_EQ(waveform(out + i * WS2812_SPI_BYTES_PER_LED, WS2812_SPI_BYTES_PER_LED), waveform(single, sizeof(single))) << "led " << (int)i;
+    }
+}
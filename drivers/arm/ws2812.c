@@ -93,3 +93,7 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
 
     chSysUnlock();
 }
+
+void ws2812_setleds_async(LED_TYPE *ledarray, uint16_t leds) { ws2812_setleds(ledarray, leds); }
+
+bool ws2812_busy(void) { return false; }
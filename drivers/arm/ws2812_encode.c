@@ -0,0 +1,23 @@
+#include "ws2812_encode.h"
+
+// SPI bytes for two LED bits, indexed by their value, most significant first
+static const uint8_t spi_bit_pairs[4] = {0x88, 0x8E, 0xE8, 0xEE};
+
+static uint8_t *encode_spi_color(uint8_t *out, uint8_t color) {
+    for (int8_t shift = 6; shift >= 0; shift -= 2) {
+        *out++ = spi_bit_pairs[(color >> shift) & 0x03];
+    }
+    return out;
+}
+
+void ws2812_encode_spi(uint8_t *out, const LED_TYPE *ledarray, uint16_t number_of_leds) {
+    for (uint16_t i = 0; i < number_of_leds; i++) {
+        // WS2812 protocol dictates grb order
+        out = encode_spi_color(out, ledarray[i].g);
+        out = encode_spi_color(out, ledarray[i].r);
+        out = encode_spi_color(out, ledarray[i].b);
+#ifdef RGBW
+        out = encode_spi_color(out, ledarray[i].w);
+#endif
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "quantum/color.h"
+
+/* Bit encoding for the DMA driven drivers
+ *
+ * The WS2812 protocol is sent by a peripheral that knows nothing about it,
+ * so each LED bit is turned into a pattern of peripheral bits up front.
+ * These routines only build the bit stream, they don't touch any hardware.
+ */
+
+#ifdef RGBW
+#    define WS2812_COLORS 4
+#else
+#    define WS2812_COLORS 3
+#endif
+
+// SPI: each LED bit takes four SPI bits, 1110 for a one and 1000 for a zero
+#define WS2812_SPI_BYTES_PER_COLOR 4
+#define WS2812_SPI_BYTES_PER_LED (WS2812_SPI_BYTES_PER_COLOR * WS2812_COLORS)
+
+// Writes WS2812_SPI_BYTES_PER_LED bytes per LED to out, in GRB(W) order
+void ws2812_encode_spi(uint8_t *out, const LED_TYPE *ledarray, uint16_t number_of_leds);
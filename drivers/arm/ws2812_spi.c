@@ -1,5 +1,6 @@
 #include "quantum.h"
 #include "ws2812.h"
+#include "ws2812_encode.h"
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -16,39 +17,34 @@
 #    define WS2812_SPI_MOSI_PAL_MODE 5
 #endif
 
-#define BYTES_FOR_LED_BYTE 4
-#define NB_COLORS 3
-#define BYTES_FOR_LED (BYTES_FOR_LED_BYTE * NB_COLORS)
-#define DATA_SIZE (BYTES_FOR_LED * RGBLED_NUM)
+#define DATA_SIZE (WS2812_SPI_BYTES_PER_LED * RGBLED_NUM)
 #define RESET_SIZE 200
 #define PREAMBLE_SIZE 4
+#define TX_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
-
-/*
- * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
- */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
-}
+// Frames are encoded into one buffer while the other is sent. Once a frame
+// is queued, txbuf[tx_back] holds it until the running transfer ends.
+static uint8_t       txbuf[2][TX_SIZE] = {{0}};
+static uint8_t       tx_back           = 0;
+static volatile bool tx_queued         = false;
+// Thread sleeping in ws2812_setleds until the last frame is out
+static thread_reference_t tx_waiting = NULL;
 
-static void set_led_color_rgb(LED_TYPE color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
+// Starts the next transfer, called with the system locked
+static void ws2812_start_send_i(void) {
+    spiStartSendI(&WS2812_SPI, TX_SIZE, txbuf[tx_back]);
+    tx_back ^= 1;
+}
 
-    for (int j = 0; j < 4; j++) tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++) tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++) tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+static void ws2812_end_cb(SPIDriver *spip) {
+    osalSysLockFromISR();
+    if (tx_queued) {
+        tx_queued = false;
+        ws2812_start_send_i();
+    } else {
+        osalThreadResumeI(&tx_waiting, MSG_OK);
+    }
+    osalSysUnlockFromISR();
 }
 
 void ws2812_init(void) {
@@ -60,7 +56,7 @@ void ws2812_init(void) {
 
     // TODO: more dynamic baudrate
     static const SPIConfig spicfg = {
-        NULL, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN),
+        ws2812_end_cb, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN),
         SPI_CR1_BR_1 | SPI_CR1_BR_0  // baudrate : fpclk / 8 => 1tick is 0.32us (2.25 MHz)
     };
 
@@ -69,22 +65,45 @@ void ws2812_init(void) {
     spiSelect(&WS2812_SPI);         /* Slave Select assertion.          */
 }
 
-void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
+void ws2812_setleds_async(LED_TYPE* ledarray, uint16_t leds) {
     static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
     }
+    if (leds > RGBLED_NUM) {
+        leds = RGBLED_NUM;
+    }
+
+    // Take back a frame that is still waiting, this one replaces it
+    osalSysLock();
+    tx_queued = false;
+    osalSysUnlock();
 
-    for (uint8_t i = 0; i < leds; i++) {
-        set_led_color_rgb(ledarray[i], i);
+    ws2812_encode_spi(&txbuf[tx_back][PREAMBLE_SIZE], ledarray, leds);
+
+    osalSysLock();
+    if (WS2812_SPI.state == SPI_READY) {
+        ws2812_start_send_i();
+    } else {
+        tx_queued = true;
     }
+    osalSysUnlock();
+}
+
+// The state is changed from the SPI interrupt, so it must be read every call
+bool ws2812_busy(void) { return tx_queued || *(volatile spistate_t *)&WS2812_SPI.state != SPI_READY; }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
+void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
+    // Each led takes ~0.03ms, 50 leds ~1.5ms. The data is copied into the
+    // buffer that isn't being sent, so frames can be set faster than they go out.
+    ws2812_setleds_async(ledarray, leds);
 #ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
-#else
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+    // Sleep until ws2812_end_cb finds nothing left to send
+    osalSysLock();
+    while (ws2812_busy()) {
+        osalThreadSuspendS(&tx_waiting);
+    }
+    osalSysUnlock();
 #endif
 }
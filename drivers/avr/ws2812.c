@@ -55,6 +55,10 @@ void inline ws2812_setleds_pin(LED_TYPE *ledarray, uint16_t leds, uint8_t pinmas
 #endif
 }
 
+void ws2812_setleds_async(LED_TYPE *ledarray, uint16_t leds) { ws2812_setleds(ledarray, leds); }
+
+bool ws2812_busy(void) { return false; }
+
 void ws2812_sendarray(uint8_t *data, uint16_t datlen) { ws2812_sendarray_mask(data, datlen, _BV(RGB_DI_PIN & 0xF)); }
 
 /*
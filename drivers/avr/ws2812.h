@@ -38,3 +38,16 @@
  */
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds);
 void ws2812_setleds_pin(LED_TYPE *ledarray, uint16_t number_of_leds, uint8_t pinmask);
+
+/* Asynchronous interface
+ *
+ * ws2812_setleds_async() starts sending the LED data and returns before the
+ * transfer is done on drivers that send it by DMA. ledarray may be changed as
+ * soon as it returns. A frame set while a transfer is running is sent right
+ * after it, replacing any frame that was already waiting.
+ * ws2812_busy() is true until every frame has been sent.
+ *
+ * The AVR drivers send the data before returning, and are never busy.
+ */
+void ws2812_setleds_async(LED_TYPE *ledarray, uint16_t number_of_leds);
+bool ws2812_busy(void);
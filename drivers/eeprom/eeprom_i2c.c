@@ -35,6 +35,16 @@
 #include "eeprom.h"
 #include "eeprom_i2c.h"
 
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+// Settings are needed straight away, so these skip past queued flushes
+#    define I2C_TRANSMIT i2c_queue_transmit
+#    define I2C_RECEIVE i2c_queue_receive
+#else
+#    define I2C_TRANSMIT i2c_transmit
+#    define I2C_RECEIVE i2c_receive
+#endif
+
 // #define DEBUG_EEPROM_OUTPUT
 
 #ifdef DEBUG_EEPROM_OUTPUT
@@ -72,8 +82,8 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     fill_target_address(complete_packet, addr);
 
     init_i2c_if_required();
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), buf, len, 100);
+    I2C_TRANSMIT(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
+    I2C_RECEIVE(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), buf, len, 100);
 
 #ifdef DEBUG_EEPROM_OUTPUT
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
@@ -110,7 +120,7 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
         dprintf("\n");
 #endif  // DEBUG_EEPROM_OUTPUT
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
+        I2C_TRANSMIT(EXTERNAL_EEPROM_I2C_ADDRESS((intptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
         wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
 
         read_buf += write_length;
@@ -0,0 +1,171 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_queue.h"
+#include "timer.h"
+
+#if I2C_QUEUE_SIZE > 254
+#    error "I2C_QUEUE_SIZE must be less than 255"
+#endif
+
+#define I2C_QUEUE_NONE 0xFF
+
+// Queued jobs, kept as one list per priority linked through slot_next
+static i2c_job_t slots[I2C_QUEUE_SIZE];
+static uint8_t   slot_next[I2C_QUEUE_SIZE];
+static bool      slot_used[I2C_QUEUE_SIZE];
+static uint8_t   queue_head[I2C_PRIORITY_COUNT] = {[0 ... I2C_PRIORITY_COUNT - 1] = I2C_QUEUE_NONE};
+static uint8_t   queue_tail[I2C_PRIORITY_COUNT];
+
+// The job being sent, which has already left the queue
+static i2c_job_t             running;
+static bool                  running_busy = false;
+static volatile bool         running_done = false;
+static volatile i2c_status_t running_status;
+
+bool i2c_queue_submit(const i2c_job_t *job, i2c_priority_t priority) {
+    uint8_t slot = 0;
+    while (slot < I2C_QUEUE_SIZE && slot_used[slot]) {
+        slot++;
+    }
+    if (slot == I2C_QUEUE_SIZE) {
+        return false;
+    }
+
+    slots[slot]     = *job;
+    slot_used[slot] = true;
+    slot_next[slot] = I2C_QUEUE_NONE;
+    if (queue_head[priority] == I2C_QUEUE_NONE) {
+        queue_head[priority] = slot;
+    } else {
+        slot_next[queue_tail[priority]] = slot;
+    }
+    queue_tail[priority] = slot;
+    return true;
+}
+
+void i2c_queue_complete(i2c_status_t status) {
+    running_status = status;
+    running_done   = true;
+}
+
+static void i2c_queue_start(const i2c_job_t *job) {
+    running      = *job;
+    running_busy = true;
+    running_done = false;
+    i2c_queue_backend_start(&running);
+}
+
+// Starts the first job of the highest priority, false if there is none
+static bool i2c_queue_start_next(void) {
+    for (uint8_t priority = 0; priority < I2C_PRIORITY_COUNT; priority++) {
+        uint8_t slot = queue_head[priority];
+        if (slot != I2C_QUEUE_NONE) {
+            queue_head[priority] = slot_next[slot];
+            slot_used[slot]      = false;
+            i2c_queue_start(&slots[slot]);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Hands the result of the running job, which must be done, to its callback
+static i2c_status_t i2c_queue_finish(void) {
+    // The callback may start the next job, so work from a copy
+    i2c_job_t    job    = running;
+    i2c_status_t status = running_status;
+    running_busy        = false;
+    if (job.callback) {
+        job.callback(&job, status);
+    }
+    return status;
+}
+
+static i2c_status_t i2c_queue_wait(void) {
+    while (!running_done) {
+    }
+    return i2c_queue_finish();
+}
+
+i2c_status_t i2c_queue_transfer(const i2c_job_t *job) {
+    if (running_busy) {
+        i2c_queue_wait();
+    }
+    i2c_queue_start(job);
+    return i2c_queue_wait();
+}
+
+i2c_status_t i2c_queue_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_job_t job = {.type = I2C_JOB_TRANSMIT, .address = address, .data = (uint8_t *)data, .length = length, .timeout = timeout};
+    return i2c_queue_transfer(&job);
+}
+
+i2c_status_t i2c_queue_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_job_t job = {.type = I2C_JOB_RECEIVE, .address = address, .data = data, .length = length, .timeout = timeout};
+    return i2c_queue_transfer(&job);
+}
+
+i2c_status_t i2c_queue_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_job_t job = {.type = I2C_JOB_WRITE_REG, .address = devaddr, .reg = regaddr, .data = (uint8_t *)data, .length = length, .timeout = timeout};
+    return i2c_queue_transfer(&job);
+}
+
+i2c_status_t i2c_queue_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_job_t job = {.type = I2C_JOB_READ_REG, .address = devaddr, .reg = regaddr, .data = data, .length = length, .timeout = timeout};
+    return i2c_queue_transfer(&job);
+}
+
+void i2c_queue_task(void) {
+    uint16_t start   = timer_read();
+    bool     started = false;
+
+    while (true) {
+        if (running_busy) {
+            if (!running_done) {
+                return;
+            }
+            i2c_queue_finish();
+        }
+        if (started && timer_elapsed(start) >= I2C_QUEUE_TASK_TIME) {
+            return;
+        }
+        if (!i2c_queue_start_next()) {
+            return;
+        }
+        started = true;
+    }
+}
+
+void i2c_queue_flush(void) {
+    do {
+        if (running_busy) {
+            i2c_queue_wait();
+        }
+    } while (i2c_queue_start_next());
+}
+
+bool i2c_queue_idle(void) {
+    if (running_busy) {
+        return false;
+    }
+    for (uint8_t priority = 0; priority < I2C_PRIORITY_COUNT; priority++) {
+        if (queue_head[priority] != I2C_QUEUE_NONE) {
+            return false;
+        }
+    }
+    return true;
+}
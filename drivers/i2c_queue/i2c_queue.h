@@ -0,0 +1,104 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_master.h"
+
+/* I2C job queue
+ *
+ * Drivers submit transfers as jobs instead of blocking on them. Queued jobs
+ * are run by i2c_queue_task() from the main loop, highest priority first and
+ * in the order they were submitted within a priority. Each call starts jobs
+ * for at most I2C_QUEUE_TASK_TIME ms, but always at least one.
+ *
+ * The data of a job isn't copied, it must stay valid until the job's
+ * callback has run. The callback runs from the main loop, never from an
+ * interrupt, and may submit more jobs.
+ *
+ * With a backend that completes transfers from an interrupt, every driver
+ * on the bus must go through the queue, so nothing is sent while a job is
+ * in flight.
+ */
+
+#ifndef I2C_QUEUE_SIZE
+#    define I2C_QUEUE_SIZE 16
+#endif
+
+#ifndef I2C_QUEUE_TASK_TIME
+#    define I2C_QUEUE_TASK_TIME 2
+#endif
+
+typedef enum {
+    I2C_PRIORITY_HIGH,    // transfers the scan is waiting on
+    I2C_PRIORITY_NORMAL,  // settings and other one-off transfers
+    I2C_PRIORITY_LOW,     // LED driver and display flushes
+    I2C_PRIORITY_COUNT,
+} i2c_priority_t;
+
+typedef enum {
+    I2C_JOB_TRANSMIT,   // i2c_transmit()
+    I2C_JOB_RECEIVE,    // i2c_receive()
+    I2C_JOB_WRITE_REG,  // i2c_writeReg()
+    I2C_JOB_READ_REG,   // i2c_readReg()
+} i2c_job_type_t;
+
+typedef struct i2c_job_t i2c_job_t;
+
+typedef void (*i2c_job_callback_t)(const i2c_job_t *job, i2c_status_t status);
+
+struct i2c_job_t {
+    i2c_job_type_t     type;
+    uint8_t            address;  // shifted, as for i2c_transmit()
+    uint8_t            reg;      // only for I2C_JOB_WRITE_REG and I2C_JOB_READ_REG
+    uint8_t *          data;
+    uint16_t           length;
+    uint16_t           timeout;
+    i2c_job_callback_t callback;  // may be NULL
+    void *             context;   // for the callback
+};
+
+// Queues a job. Returns false, without queueing it, if the queue is full.
+bool i2c_queue_submit(const i2c_job_t *job, i2c_priority_t priority);
+
+// Runs a job as soon as the running job ends, ahead of everything queued,
+// and waits for it to finish.
+i2c_status_t i2c_queue_transfer(const i2c_job_t *job);
+
+// Blocking transfers run through i2c_queue_transfer()
+i2c_status_t i2c_queue_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_queue_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_queue_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_queue_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout);
+
+void i2c_queue_task(void);
+
+// Runs every queued job, and waits for them to finish
+void i2c_queue_flush(void);
+
+// True when no job is queued or running
+bool i2c_queue_idle(void);
+
+/* Backend
+ *
+ * i2c_queue_backend_start() starts sending a job, and i2c_queue_complete()
+ * is called once it is done. That can be from an interrupt, or before
+ * i2c_queue_backend_start() returns for backends that block.
+ */
+void i2c_queue_backend_start(const i2c_job_t *job);
+void i2c_queue_complete(i2c_status_t status);
@@ -0,0 +1,39 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_queue.h"
+
+// Sends each job with the blocking i2c_master functions, so it is done
+// before i2c_queue_backend_start() returns
+void i2c_queue_backend_start(const i2c_job_t *job) {
+    i2c_status_t status = I2C_STATUS_ERROR;
+
+    switch (job->type) {
+        case I2C_JOB_TRANSMIT:
+            status = i2c_transmit(job->address, job->data, job->length, job->timeout);
+            break;
+        case I2C_JOB_RECEIVE:
+            status = i2c_receive(job->address, job->data, job->length, job->timeout);
+            break;
+        case I2C_JOB_WRITE_REG:
+            status = i2c_writeReg(job->address, job->reg, job->data, job->length, job->timeout);
+            break;
+        case I2C_JOB_READ_REG:
+            status = i2c_readReg(job->address, job->reg, job->data, job->length, job->timeout);
+            break;
+    }
+    i2c_queue_complete(status);
+}
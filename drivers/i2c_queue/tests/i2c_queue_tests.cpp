@@ -0,0 +1,182 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <vector>
+extern "C" {
+#include "i2c_queue.h"
+#include "timer.h"
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// A fake bus. Each transfer takes transfer_time ms, and either ends before
+// i2c_queue_backend_start() returns, or when the test ends it, like an
+// interrupt driven backend.
+class I2CQueue : public testing::Test {
+   public:
+    I2CQueue() {
+        Instance = this;
+        set_time(0);
+        i2c_queue_flush();
+        started.clear();
+        finished.clear();
+    }
+
+    ~I2CQueue() {
+        async = false;
+        if (!i2c_queue_idle()) {
+            end_transfer(I2C_STATUS_SUCCESS);
+            i2c_queue_flush();
+        }
+        Instance = nullptr;
+    }
+
+    void start(const i2c_job_t* job) {
+        started.push_back(job->reg);
+        advance_time(transfer_time);
+        if (!async) {
+            i2c_queue_complete(status);
+        }
+    }
+
+    void end_transfer(i2c_status_t result) { i2c_queue_complete(result); }
+
+    bool submit(uint8_t id, i2c_priority_t priority) {
+        i2c_job_t job = {};
+        job.type      = I2C_JOB_WRITE_REG;
+        job.address   = 0x20;
+        job.reg       = id;
+        job.callback  = job_done;
+        return i2c_queue_submit(&job, priority);
+    }
+
+    static void job_done(const i2c_job_t* job, i2c_status_t status) {
+        Instance->finished.push_back(job->reg);
+        Instance->statuses.push_back(status);
+        if (Instance->resubmit && job->reg < 10) {
+            Instance->submit(job->reg + 10, I2C_PRIORITY_LOW);
+        }
+    }
+
+    static I2CQueue* Instance;
+
+    std::vector<uint8_t>      started;
+    std::vector<uint8_t>      finished;
+    std::vector<i2c_status_t> statuses;
+    uint16_t                  transfer_time = 0;
+    i2c_status_t              status        = I2C_STATUS_SUCCESS;
+    bool                      async         = false;
+    bool                      resubmit      = false;
+};
+
+I2CQueue* I2CQueue::Instance = nullptr;
+
+extern "C" {
+void i2c_queue_backend_start(const i2c_job_t* job) { I2CQueue::Instance->start(job); }
+}
+
+TEST_F(I2CQueue, runs_jobs_by_priority) {
+    submit(1, I2C_PRIORITY_LOW);
+    submit(2, I2C_PRIORITY_NORMAL);
+    submit(3, I2C_PRIORITY_HIGH);
+    submit(4, I2C_PRIORITY_LOW);
+    submit(5, I2C_PRIORITY_HIGH);
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{3, 5, 2, 1, 4}));
+    EXPECT_EQ(finished, started);
+    EXPECT_TRUE(i2c_queue_idle());
+}
+
+TEST_F(I2CQueue, refuses_jobs_when_full) {
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(submit(i, I2C_PRIORITY_LOW));
+    }
+    EXPECT_FALSE(submit(100, I2C_PRIORITY_HIGH));
+    i2c_queue_task();
+    EXPECT_EQ(started.size(), (size_t)I2C_QUEUE_SIZE);
+    EXPECT_TRUE(submit(100, I2C_PRIORITY_HIGH));
+}
+
+TEST_F(I2CQueue, limits_the_time_spent_per_task) {
+    transfer_time = 1;
+    for (uint8_t i = 0; i < 6; i++) {
+        submit(i, I2C_PRIORITY_LOW);
+    }
+    i2c_queue_task();
+    EXPECT_EQ(started.size(), (size_t)I2C_QUEUE_TASK_TIME);
+    i2c_queue_task();
+    EXPECT_EQ(started.size(), (size_t)2 * I2C_QUEUE_TASK_TIME);
+}
+
+TEST_F(I2CQueue, starts_a_slow_job_every_task) {
+    transfer_time = 10;
+    submit(1, I2C_PRIORITY_LOW);
+    submit(2, I2C_PRIORITY_LOW);
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{1}));
+    EXPECT_EQ(finished, (std::vector<uint8_t>{1}));
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{1, 2}));
+}
+
+TEST_F(I2CQueue, passes_the_status_to_the_callback) {
+    status = I2C_STATUS_TIMEOUT;
+    submit(1, I2C_PRIORITY_NORMAL);
+    i2c_queue_task();
+    EXPECT_EQ(statuses, (std::vector<i2c_status_t>{I2C_STATUS_TIMEOUT}));
+}
+
+TEST_F(I2CQueue, transfers_go_ahead_of_the_queue) {
+    submit(1, I2C_PRIORITY_HIGH);
+    submit(2, I2C_PRIORITY_LOW);
+    uint8_t data = 0;
+    EXPECT_EQ(i2c_queue_readReg(0x20, 7, &data, 1, 100), I2C_STATUS_SUCCESS);
+    EXPECT_EQ(started, (std::vector<uint8_t>{7}));
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{7, 1, 2}));
+}
+
+TEST_F(I2CQueue, waits_for_the_running_job) {
+    async = true;
+    submit(1, I2C_PRIORITY_LOW);
+    submit(2, I2C_PRIORITY_LOW);
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{1}));
+    EXPECT_TRUE(finished.empty());
+
+    // Nothing else starts while the job is in flight
+    i2c_queue_task();
+    EXPECT_EQ(started, (std::vector<uint8_t>{1}));
+    EXPECT_FALSE(i2c_queue_idle());
+
+    // The callback runs from the task, not from the interrupt
+    end_transfer(I2C_STATUS_ERROR);
+    EXPECT_TRUE(finished.empty());
+    i2c_queue_task();
+    EXPECT_EQ(finished, (std::vector<uint8_t>{1}));
+    EXPECT_EQ(statuses, (std::vector<i2c_status_t>{I2C_STATUS_ERROR}));
+    EXPECT_EQ(started, (std::vector<uint8_t>{1, 2}));
+}
+
+TEST_F(I2CQueue, callbacks_can_submit_jobs) {
+    resubmit = true;
+    submit(1, I2C_PRIORITY_LOW);
+    submit(2, I2C_PRIORITY_LOW);
+    i2c_queue_flush();
+    EXPECT_EQ(started, (std::vector<uint8_t>{1, 2, 11, 12}));
+    EXPECT_TRUE(i2c_queue_idle());
+}
@@ -0,0 +1,8 @@
+i2c_queue_DEFS := -DI2C_QUEUE_SIZE=8
+i2c_queue_INC := \
+	$(DRIVER_PATH)/i2c_queue \
+	$(DRIVER_PATH)/i2c_queue/tests
+i2c_queue_SRC := \
+	$(DRIVER_PATH)/i2c_queue/tests/i2c_queue_tests.cpp \
+	$(DRIVER_PATH)/i2c_queue/i2c_queue.c \
+	$(TMK_PATH)/common/test/timer.c
@@ -17,7 +17,11 @@
 
 #include "is31fl3731.h"
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
 #include "wait.h"
+#include <string.h>
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -63,6 +67,8 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][144];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// One bit per PWM register, set while the buffer differs from the device
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][18];
 
 uint8_t g_led_control_registers[DRIVER_COUNT][18]             = {{0}, {0}};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -121,6 +127,78 @@ void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+#ifdef I2C_QUEUE_ENABLE
+// A queued block that failed to send is marked dirty again, to be sent with
+// the next flush. The job's context points at the block's dirty bits.
+static void IS31FL3731_pwm_block_done(const i2c_job_t *job, i2c_status_t status) {
+    if (status != I2C_STATUS_SUCCESS) {
+        uint8_t *dirty = job->context;
+        dirty[0]       = 0xFF;
+        dirty[1]       = 0xFF;
+        g_pwm_buffer_update_required[(dirty - g_pwm_buffer_dirty[0]) / sizeof(g_pwm_buffer_dirty[0])] = true;
+    }
+}
+#endif
+
+// Sends only the PWM registers changed since they were last sent, as one
+// transfer per 16 register block with changes. Blocks with no changes,
+// and so unchanged controllers, cost nothing. Registers of a failed
+// transfer stay dirty and false is returned.
+//
+// With the I2C queue the blocks are queued at low priority and sent
+// straight from pwm_buffer. Their dirty bits are cleared once queued, so
+// registers changed while a block waits are sent again with the next flush.
+static bool IS31FL3731_write_pwm_buffer_dirty(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    bool success = true;
+
+    for (int i = 0; i < 144; i += 16) {
+        uint16_t changed = dirty[i / 8] | (dirty[i / 8 + 1] << 8);
+        if (!changed) {
+            continue;
+        }
+        // Send from the first to the last changed register in the block
+        uint8_t first = 0;
+        uint8_t last  = 15;
+        while (!(changed & (1 << first))) first++;
+        while (!(changed & (1 << last))) last--;
+
+#ifdef I2C_QUEUE_ENABLE
+        i2c_job_t job = {
+            .type     = I2C_JOB_WRITE_REG,
+            .address  = addr << 1,
+            .reg      = 0x24 + i + first,
+            .data     = &pwm_buffer[i + first],
+            .length   = last - first + 1,
+            .timeout  = ISSI_TIMEOUT,
+            .callback = IS31FL3731_pwm_block_done,
+            .context  = &dirty[i / 8],
+        };
+        bool sent = i2c_queue_submit(&job, I2C_PRIORITY_LOW);
+#else
+        g_twi_transfer_buffer[0] = 0x24 + i + first;
+        for (int j = first; j <= last; j++) {
+            g_twi_transfer_buffer[1 + j - first] = pwm_buffer[i + j];
+        }
+
+        bool sent = false;
+#    if ISSI_PERSISTENCE > 0
+        for (uint8_t k = 0; k < ISSI_PERSISTENCE && !sent; k++) {
+            sent = i2c_transmit(addr << 1, g_twi_transfer_buffer, last - first + 2, ISSI_TIMEOUT) == 0;
+        }
+#    else
+        sent = i2c_transmit(addr << 1, g_twi_transfer_buffer, last - first + 2, ISSI_TIMEOUT) == 0;
+#    endif
+#endif
+        if (sent) {
+            dirty[i / 8]     = 0;
+            dirty[i / 8 + 1] = 0;
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
 void IS31FL3731_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, first enable software shutdown,
@@ -171,6 +249,20 @@ void IS31FL3731_init(uint8_t addr) {
     // most usage after initialization is just writing PWM buffers in bank 0
     // as there's not much point in double-buffering
     IS31FL3731_write_register(addr, ISSI_COMMANDREGISTER, 0);
+
+    // The PWM registers were just cleared, send the whole buffer on the next update
+    memset(g_pwm_buffer_dirty, 0xFF, sizeof(g_pwm_buffer_dirty));
+    for (int i = 0; i < DRIVER_COUNT; i++) {
+        g_pwm_buffer_update_required[i] = true;
+    }
+}
+
+static void IS31FL3731_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty[driver][reg / 8] |= (1 << (reg % 8));
+        g_pwm_buffer_update_required[driver] = true;
+    }
 }
 
 void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
@@ -178,10 +270,9 @@ void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         is31_led led = g_is31_leds[index];
 
         // Subtract 0x24 to get the second index of g_pwm_buffer
-        g_pwm_buffer[led.driver][led.r - 0x24]   = red;
-        g_pwm_buffer[led.driver][led.g - 0x24]   = green;
-        g_pwm_buffer[led.driver][led.b - 0x24]   = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3731_set_pwm(led.driver, led.r - 0x24, red);
+        IS31FL3731_set_pwm(led.driver, led.g - 0x24, green);
+        IS31FL3731_set_pwm(led.driver, led.b - 0x24, blue);
     }
 }
 
@@ -222,9 +313,8 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
 
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
-        IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        g_pwm_buffer_update_required[index] = !IS31FL3731_write_pwm_buffer_dirty(addr, g_pwm_buffer[index], g_pwm_buffer_dirty[index]);
     }
-    g_pwm_buffer_update_required[index] = false;
 }
 
 void IS31FL3731_update_led_control_registers(uint8_t addr, uint8_t index) {
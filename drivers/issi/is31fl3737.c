@@ -19,6 +19,7 @@
 #include "is31fl3737.h"
 #include "i2c_master.h"
 #include "wait.h"
+#include <string.h>
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -67,6 +68,8 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
 bool    g_pwm_buffer_update_required = false;
+// One bit per PWM register, set while the buffer differs from the device
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][24];
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24] = {{0}};
 bool    g_led_control_registers_update_required   = false;
@@ -110,6 +113,47 @@ void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Sends only the PWM registers changed since they were last sent, as one
+// transfer per 16 register block with changes. Blocks with no changes,
+// and so unchanged controllers, cost nothing. Registers of a failed
+// transfer stay dirty and false is returned.
+static bool IS31FL3737_write_pwm_buffer_dirty(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    bool success = true;
+
+    for (int i = 0; i < 192; i += 16) {
+        uint16_t changed = dirty[i / 8] | (dirty[i / 8 + 1] << 8);
+        if (!changed) {
+            continue;
+        }
+        // Send from the first to the last changed register in the block
+        uint8_t first = 0;
+        uint8_t last  = 15;
+        while (!(changed & (1 << first))) first++;
+        while (!(changed & (1 << last))) last--;
+
+        g_twi_transfer_buffer[0] = i + first;
+        for (int j = first; j <= last; j++) {
+            g_twi_transfer_buffer[1 + j - first] = pwm_buffer[i + j];
+        }
+
+        bool sent = false;
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t k = 0; k < ISSI_PERSISTENCE && !sent; k++) {
+            sent = i2c_transmit(addr << 1, g_twi_transfer_buffer, last - first + 2, ISSI_TIMEOUT) == 0;
+        }
+#else
+        sent = i2c_transmit(addr << 1, g_twi_transfer_buffer, last - first + 2, ISSI_TIMEOUT) == 0;
+#endif
+        if (sent) {
+            dirty[i / 8]     = 0;
+            dirty[i / 8 + 1] = 0;
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
 void IS31FL3737_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -149,16 +193,27 @@ void IS31FL3737_init(uint8_t addr) {
 
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
+
+    // The PWM registers were just cleared, send the whole buffer on the next update
+    memset(g_pwm_buffer_dirty, 0xFF, sizeof(g_pwm_buffer_dirty));
+    g_pwm_buffer_update_required = true;
+}
+
+static void IS31FL3737_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty[driver][reg / 8] |= (1 << (reg % 8));
+        g_pwm_buffer_update_required = true;
+    }
 }
 
 void IS31FL3737_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        IS31FL3737_set_pwm(led.driver, led.r, red);
+        IS31FL3737_set_pwm(led.driver, led.g, green);
+        IS31FL3737_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -203,10 +258,9 @@ void IS31FL3737_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
         IS31FL3737_write_register(addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3737_write_register(addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3737_write_pwm_buffer(addr1, g_pwm_buffer[0]);
+        g_pwm_buffer_update_required = !IS31FL3737_write_pwm_buffer_dirty(addr1, g_pwm_buffer[0], g_pwm_buffer_dirty[0]);
         // IS31FL3737_write_pwm_buffer(addr2, g_pwm_buffer[1]);
     }
-    g_pwm_buffer_update_required = false;
 }
 
 void IS31FL3737_update_led_control_registers(uint8_t addr1, uint8_t addr2) {
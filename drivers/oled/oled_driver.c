@@ -28,7 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #elif defined(ESP8266)
 #    include <pgmspace.h>
 #else  // defined(ESP8266)
-#    define PROGMEM
+#    include "progmem.h"
 #    define memcpy_P(des, src, len) memcpy(des, src, len)
 #endif  // defined(__AVR__)
 
@@ -120,6 +120,22 @@ uint32_t oled_timeout;
 uint32_t oled_scroll_timeout;
 #endif
 
+// The changed bytes of each dirty block, as offsets into the block
+#if OLED_MATRIX_SIZE / 8 > 256
+typedef uint16_t oled_span_t;
+#else
+typedef uint8_t oled_span_t;
+#endif
+static oled_span_t oled_dirty_first[OLED_BLOCK_COUNT];
+static oled_span_t oled_dirty_last[OLED_BLOCK_COUNT];
+
+// Frames finished and bytes sent, counted up over a second
+static uint16_t oled_frames        = 0;
+static uint32_t oled_bytes         = 0;
+static uint16_t oled_fps           = 0;
+static uint32_t oled_bytes_per_sec = 0;
+static uint32_t oled_stats_timer   = 0;
+
 // Internal variables to reduce math instructions
 
 #if defined(__AVR__)
@@ -216,16 +232,46 @@ bool oled_init(uint8_t rotation) {
 
 __attribute__((weak)) oled_rotation_t oled_init_user(oled_rotation_t rotation) { return rotation; }
 
+// Marks the bytes from start to end of the buffer as changed
+static void oled_mark_dirty(uint16_t start, uint16_t end) {
+    if (end >= OLED_MATRIX_SIZE) {
+        end = OLED_MATRIX_SIZE - 1;
+    }
+    for (uint8_t block = start / OLED_BLOCK_SIZE; block <= end / OLED_BLOCK_SIZE; block++) {
+        uint16_t        block_start = block * OLED_BLOCK_SIZE;
+        oled_span_t     first       = start > block_start ? start - block_start : 0;
+        oled_span_t     last        = end - block_start < OLED_BLOCK_SIZE ? end - block_start : OLED_BLOCK_SIZE - 1;
+        OLED_BLOCK_TYPE bit         = (OLED_BLOCK_TYPE)1 << block;
+        if (!(oled_dirty & bit)) {
+            oled_dirty |= bit;
+            oled_dirty_first[block] = first;
+            oled_dirty_last[block]  = last;
+        } else {
+            if (first < oled_dirty_first[block]) oled_dirty_first[block] = first;
+            if (last > oled_dirty_last[block]) oled_dirty_last[block] = last;
+        }
+    }
+}
+
+// Writes a byte of the buffer, marking it dirty only if it changed
+static void oled_write_byte(uint16_t index, uint8_t data) {
+    if (oled_buffer[index] == data) {
+        return;
+    }
+    oled_buffer[index] = data;
+    oled_mark_dirty(index, index);
+}
+
 void oled_clear(void) {
     memset(oled_buffer, 0, sizeof(oled_buffer));
     oled_cursor = &oled_buffer[0];
-    oled_dirty  = -1;  // -1 will be max value as long as display_dirty is unsigned type
+    oled_mark_dirty(0, OLED_MATRIX_SIZE - 1);
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint16_t start, uint16_t length, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint8_t start_page   = start / OLED_DISPLAY_WIDTH;
+    uint8_t start_column = start % OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
@@ -239,8 +285,8 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     // Commands for use in Horizontal Addressing mode.
     cmd_array[1] = start_column;
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    cmd_array[2] = (length + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
+    cmd_array[5] = (length + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
 #endif
 }
 
@@ -267,22 +313,27 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
-void oled_render(void) {
-    // Do we have work to do?
-    if (!oled_dirty || oled_scrolling) {
-        return;
-    }
-
+// Sends the changed bytes of the first dirty block, false if that failed
+static bool oled_render_block(void) {
     // Find first dirty block
     uint8_t update_start = 0;
-    while (!(oled_dirty & (1 << update_start))) {
+    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
         ++update_start;
     }
 
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+    uint16_t       start           = OLED_BLOCK_SIZE * update_start;
+    uint16_t       length          = OLED_BLOCK_SIZE;
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        // Only the changed bytes, when they are on one page
+        uint16_t first = start + oled_dirty_first[update_start];
+        uint16_t last  = start + oled_dirty_last[update_start];
+        if (first / OLED_DISPLAY_WIDTH == last / OLED_DISPLAY_WIDTH) {
+            start  = first;
+            length = last - first + 1;
+        }
+        calc_bounds(start, length, &display_start[1]);  // Offset from I2C_CMD byte at the start
     } else {
         calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
     }
@@ -290,14 +341,14 @@ void oled_render(void) {
     // Send column & page position
     if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
         print("oled_render offset command failed\n");
-        return;
+        return false;
     }
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
         // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[start], length) != I2C_STATUS_SUCCESS) {
             print("oled_render data failed\n");
-            return;
+            return false;
         }
     } else {
         // Rotate the render chunks
@@ -313,17 +364,42 @@ void oled_render(void) {
         // Send render data chunk after rotating
         if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
             print("oled_render90 data failed\n");
-            return;
+            return false;
         }
     }
 
+    // Clear dirty flag
+    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+    oled_bytes += length;
+    return true;
+}
+
+void oled_render(void) {
+    // Do we have work to do?
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+    // Send blocks until the time is up, giving the scan loop a turn in between
+    uint16_t render_start = timer_read();
+    do {
+        if (!oled_render_block()) {
+            return;
+        }
+    } while (oled_dirty && timer_elapsed(render_start) < OLED_RENDER_TIME);
+
     // Turn on display if it is off
     oled_on();
 
-    // Clear dirty flag
-    oled_dirty &= ~(1 << update_start);
+    if (!oled_dirty) {
+        oled_frames++;
+    }
 }
 
+uint16_t oled_render_fps(void) { return oled_fps; }
+
+uint32_t oled_render_bytes_per_second(void) { return oled_bytes_per_sec; }
+
 void oled_set_cursor(uint8_t col, uint8_t line) {
     uint16_t index = line * oled_rotation_width + col * OLED_FONT_WIDTH;
 
@@ -406,12 +482,18 @@ void oled_write_char(const char data, bool invert) {
         InvertCharacter(oled_cursor);
     }
 
-    // Dirty check
-    if (memcmp(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH)) {
+    // Dirty check, down to the columns that changed
+    uint8_t first = 0;
+    while (first < OLED_FONT_WIDTH && oled_temp_buffer[first] == oled_cursor[first]) {
+        first++;
+    }
+    if (first < OLED_FONT_WIDTH) {
+        uint8_t last = OLED_FONT_WIDTH - 1;
+        while (oled_temp_buffer[last] == oled_cursor[last]) {
+            last--;
+        }
         uint16_t index = oled_cursor - &oled_buffer[0];
-        oled_dirty |= (1 << (index / OLED_BLOCK_SIZE));
-        // Edgecase check if the written data spans the 2 chunks
-        oled_dirty |= (1 << ((index + OLED_FONT_WIDTH) / OLED_BLOCK_SIZE));
+        oled_mark_dirty(index + first, index + last);
     }
 
     // Finally move to the next char
@@ -434,9 +516,90 @@ void oled_write_ln(const char *data, bool invert) {
 void oled_write_raw(const char *data, uint16_t size) {
     if (size > OLED_MATRIX_SIZE) size = OLED_MATRIX_SIZE;
     for (uint16_t i = 0; i < size; i++) {
-        if (oled_buffer[i] == data[i]) continue;
-        oled_buffer[i] = data[i];
-        oled_dirty |= (1 << (i / OLED_BLOCK_SIZE));
+        oled_write_byte(i, data[i]);
+    }
+}
+
+void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
+    uint16_t index = (uint16_t)(y / 8) * oled_rotation_width + x;
+    if (x >= oled_rotation_width || index >= OLED_MATRIX_SIZE) {
+        return;
+    }
+    uint8_t bit = 1 << (y % 8);
+    oled_write_byte(index, on ? oled_buffer[index] | bit : oled_buffer[index] & ~bit);
+}
+
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    if (x >= oled_rotation_width || width == 0 || height == 0) {
+        return;
+    }
+    if (width > oled_rotation_width - x) {
+        width = oled_rotation_width - x;
+    }
+
+    uint16_t bottom = y + height;
+    for (uint16_t page = y / 8; page * 8 < bottom; page++) {
+        uint16_t row = page * oled_rotation_width + x;
+        if (row >= OLED_MATRIX_SIZE) {
+            break;
+        }
+
+        // The bits of this page inside the rectangle
+        uint8_t mask = 0xFF;
+        if (page == y / 8) {
+            mask &= 0xFF << (y % 8);
+        }
+        if (bottom < page * 8 + 8) {
+            mask &= 0xFF >> (page * 8 + 8 - bottom);
+        }
+
+        for (uint8_t col = 0; col < width; col++) {
+            uint8_t data = oled_buffer[row + col];
+            oled_write_byte(row + col, on ? data | mask : data & ~mask);
+        }
+    }
+}
+
+void oled_write_sprite(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) {
+    for (uint8_t p = 0; p < pages; p++) {
+        uint16_t row = (uint16_t)(page + p) * oled_rotation_width;
+        if (row >= OLED_MATRIX_SIZE) {
+            break;
+        }
+        for (uint8_t col = 0; col < width && x + col < oled_rotation_width; col++) {
+            oled_write_byte(row + x + col, data[p * width + col]);
+        }
+    }
+}
+
+void oled_write_image_P(const uint8_t *image, uint8_t x, uint8_t page) {
+    uint8_t width = pgm_read_byte(image++);
+    uint8_t pages = pgm_read_byte(image++);
+    uint8_t col   = 0;
+    uint8_t row   = 0;
+
+    while (row < pages) {
+        uint8_t op     = pgm_read_byte(image++);
+        bool    skip   = op >= OLED_IMAGE_SKIP;
+        bool    repeat = !skip && op >= OLED_IMAGE_REPEAT;
+        uint8_t count  = op < OLED_IMAGE_REPEAT ? op + 1 : (op & 0x3F) + (repeat ? 2 : 1);
+        uint8_t data   = repeat ? pgm_read_byte(image++) : 0;
+
+        for (; count > 0 && row < pages; count--) {
+            if (!skip) {
+                if (!repeat) {
+                    data = pgm_read_byte(image++);
+                }
+                uint16_t index = (uint16_t)(page + row) * oled_rotation_width + x + col;
+                if (x + col < oled_rotation_width && index < OLED_MATRIX_SIZE) {
+                    oled_write_byte(index, data);
+                }
+            }
+            if (++col == width) {
+                col = 0;
+                row++;
+            }
+        }
     }
 }
 
@@ -457,10 +620,19 @@ void oled_write_ln_P(const char *data, bool invert) {
 void oled_write_raw_P(const char *data, uint16_t size) {
     if (size > OLED_MATRIX_SIZE) size = OLED_MATRIX_SIZE;
     for (uint16_t i = 0; i < size; i++) {
-        uint8_t c = pgm_read_byte(++data);
-        if (oled_buffer[i] == c) continue;
-        oled_buffer[i] = c;
-        oled_dirty |= (1 << (i / OLED_BLOCK_SIZE));
+        oled_write_byte(i, pgm_read_byte(data++));
+    }
+}
+
+void oled_write_sprite_P(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) {
+    for (uint8_t p = 0; p < pages; p++) {
+        uint16_t row = (uint16_t)(page + p) * oled_rotation_width;
+        if (row >= OLED_MATRIX_SIZE) {
+            break;
+        }
+        for (uint8_t col = 0; col < width && x + col < oled_rotation_width; col++) {
+            oled_write_byte(row + x + col, pgm_read_byte(&data[p * width + col]));
+        }
     }
 }
 #endif  // defined(__AVR__)
@@ -529,7 +701,7 @@ bool oled_scroll_off(void) {
             return oled_scrolling;
         }
         oled_scrolling = false;
-        oled_dirty     = -1;
+        oled_mark_dirty(0, OLED_MATRIX_SIZE - 1);
     }
     return !oled_scrolling;
 }
@@ -567,6 +739,14 @@ void oled_task(void) {
     // Smart render system, no need to check for dirty
     oled_render();
 
+    if (timer_elapsed32(oled_stats_timer) >= 1000) {
+        oled_stats_timer   = timer_read32();
+        oled_fps           = oled_frames;
+        oled_bytes_per_sec = oled_bytes;
+        oled_frames        = 0;
+        oled_bytes         = 0;
+    }
+
     // Display timeout check
 #if OLED_TIMEOUT > 0
     if (oled_active && timer_expired32(timer_read32(), oled_timeout)) {
@@ -142,6 +142,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_FONT_HEIGHT 8
 #endif
 
+// Milliseconds oled_render() may keep sending changed blocks for
+// It always sends at least one
+#if !defined(OLED_RENDER_TIME)
+#    define OLED_RENDER_TIME 0
+#endif
+
 #if !defined(OLED_TIMEOUT)
 #    if defined(OLED_DISABLE_TIMEOUT)
 #        define OLED_TIMEOUT 0
@@ -171,8 +177,15 @@ oled_rotation_t oled_init_user(oled_rotation_t rotation);
 void oled_clear(void);
 
 // Renders the dirty chunks of the buffer to oled display
+// Sends only the changed bytes of each chunk, for up to OLED_RENDER_TIME ms per call
 void oled_render(void);
 
+// Returns how many times the display was brought up to date over the last second
+uint16_t oled_render_fps(void);
+
+// Returns how many bytes of display data were sent over the last second
+uint32_t oled_render_bytes_per_second(void);
+
 // Moves cursor to character position indicated by column and line, wraps if out of bounds
 // Max column denoted by 'oled_max_chars()' and max lines by 'oled_max_lines()' functions
 void oled_set_cursor(uint8_t col, uint8_t line);
@@ -202,6 +215,34 @@ void oled_write_ln(const char *data, bool invert);
 
 void oled_write_raw(const char *data, uint16_t size);
 
+// Sets or clears a single pixel, x and y in pixels from the top left
+void oled_write_pixel(uint8_t x, uint8_t y, bool on);
+
+// Sets or clears every pixel of a rectangle, x and y in pixels from the top left
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Copies a sprite to column x of the given page (a row 8 pixels tall)
+// The sprite is laid out like the buffer, width bytes for each of its pages
+// Only the bytes that change are marked for rendering
+void oled_write_sprite(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);
+
+/* Compressed images, as made by `qmk oled-image`
+ *
+ * Two bytes of width and pages, then runs that fill the image a page at a
+ * time, from left to right:
+ *   0nnnnnnn        n + 1 bytes follow, copied as they are
+ *   10nnnnnn data   data repeated n + 2 times
+ *   11nnnnnn        n + 1 bytes left as they are on screen
+ * Skips are what make animation frames small, they only hold what differs
+ * from the frame before, so frames have to be drawn in order.
+ */
+#define OLED_IMAGE_REPEAT 0x80
+#define OLED_IMAGE_SKIP 0xC0
+
+// Draws a PROGMEM compressed image at column x of the given page
+// Only the bytes that change are marked for rendering
+void oled_write_image_P(const uint8_t *image, uint8_t x, uint8_t page);
+
 #if defined(__AVR__)
 // Writes a PROGMEM string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -215,6 +256,10 @@ void oled_write_P(const char *data, bool invert);
 void oled_write_ln_P(const char *data, bool invert);
 
 void oled_write_raw_P(const char *data, uint16_t size);
+
+// Copies a PROGMEM sprite to column x of the given page
+// Remapped to call 'void oled_write_sprite(...);' on ARM
+void oled_write_sprite_P(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);
 #else
 // Writes a string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -226,6 +271,8 @@ void oled_write_raw_P(const char *data, uint16_t size);
 #    define oled_write_ln_P(data, invert) oled_write(data, invert)
 
 #    define oled_write_raw_P(data, size) oled_write_raw(data, size)
+
+#    define oled_write_sprite_P(data, x, page, width, pages) oled_write_sprite(data, x, page, width, pages)
 #endif  // defined(__AVR__)
 
 // Can be used to manually turn on the screen if it is off
@@ -28,6 +28,7 @@ Ported to QMK by Peter Roe <pete@13bit.me>
 #include "matrix.h"
 #include "report.h"
 #include "host.h"
+#include "mouse_accumulator.h"
 #include "led.h"
 #include "timer.h"
 
@@ -135,7 +136,13 @@ void adb_mouse_task(void)
             print_decs(mouse_report.y); print("]\n");
     }
     // Send result by usb.
-    host_mouse_send(&mouse_report);
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+    // The accumulator spreads accelerated movement over several reports
+    mouse_accumulator_move(x, y, 0, 0);
+    mouse_accumulator_buttons(MOUSE_SOURCE_ADB, mouse_report.buttons);
+#else
+    MOUSE_REPORT_SEND(MOUSE_SOURCE_ADB, &mouse_report);
+#endif
     // increase acceleration of mouse
     mouseacc += ( mouseacc < ADB_MOUSE_MAXACC ? 1 : 0 );
     return;
@@ -13,5 +13,6 @@ from . import json
 from . import list
 from . import kle2json
 from . import new
+from . import oled_image
 from . import pyformat
 from . import pytest
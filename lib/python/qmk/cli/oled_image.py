@@ -0,0 +1,63 @@
+"""Convert images to compressed OLED images.
+"""
+import os
+
+from milc import cli
+
+import qmk.path
+from qmk.oled import ImageError, encode_frames, image2oled, read_pbm, to_c
+
+
+@cli.argument('filenames', nargs='+', arg_only=True, help='PBM image(s) to convert, several are the frames of an animation')
+@cli.argument('-n', '--name', arg_only=True, help='Name of the C array, defaults to the name of the first image')
+@cli.argument('-o', '--output', arg_only=True, help='File to write the C source to, defaults to stdout')
+@cli.argument('-i', '--invert', arg_only=True, action='store_true', help='Light the white pixels instead of the black ones')
+@cli.subcommand('Convert images to compressed arrays for oled_write_image_P()')
+def oled_image(cli):
+    """Convert PBM images to compressed arrays for oled_write_image_P().
+
+    Every frame of an animation after the first only holds the bytes that differ from the frame before.
+    """
+    frames = []
+    size = None
+
+    for filename in cli.args.filenames:
+        path = qmk.path.normpath(filename)
+        if not os.path.exists(path):
+            cli.log.error('File {fg_cyan}%s{style_reset_all} was not found.', filename)
+            return False
+
+        try:
+            with open(path, 'rb') as fd:
+                width, height, rows = read_pbm(fd.read())
+        except ImageError as e:
+            cli.log.error('Could not read {fg_cyan}%s{style_reset_all}: %s', filename, e)
+            return False
+
+        if width > 255 or height > 255 * 8:
+            cli.log.error('{fg_cyan}%s{style_reset_all} is too big, images can be at most 255 pixels wide.', filename)
+            return False
+        if size and size != (width, height):
+            cli.log.error('{fg_cyan}%s{style_reset_all} is %dx%d, but the first frame is %dx%d.', filename, width, height, *size)
+            return False
+
+        size = (width, height)
+        frames.append(image2oled(width, height, rows, cli.args.invert))
+
+    width, height = size
+    pages = (height + 7) // 8
+    encoded = encode_frames(width, pages, frames)
+
+    name = cli.args.name or os.path.splitext(os.path.basename(cli.args.filenames[0]))[0].replace('-', '_')
+    source = to_c(name, encoded)
+
+    if cli.args.output:
+        with open(qmk.path.normpath(cli.args.output), 'w') as fd:
+            fd.write(source)
+    else:
+        print(source)
+
+    raw = width * pages * len(frames)
+    compressed = sum(len(image) for image in encoded)
+    cli.log.info('Compressed %d frame(s) of %dx%d from %d to %d bytes.', len(frames), width, pages * 8, raw, compressed)
+    return True
@@ -0,0 +1,192 @@
+"""Functions to convert images to the compressed format drawn by oled_write_image_P().
+"""
+OLED_IMAGE_REPEAT = 0x80
+OLED_IMAGE_SKIP = 0xC0
+
+MAX_LITERAL = 128
+MAX_REPEAT = 65
+MAX_SKIP = 64
+
+
+class ImageError(Exception):
+    """Raised when an image can't be read.
+    """
+
+
+def _pbm_tokens(data):
+    """Yields the whitespace separated header fields of a PBM, skipping comments, followed by the offset of the pixel data.
+    """
+    pos = 0
+    while True:
+        while pos < len(data) and data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while pos < len(data) and data[pos:pos + 1] not in (b'\n', b'\r'):
+                pos += 1
+            continue
+        start = pos
+        while pos < len(data) and not data[pos:pos + 1].isspace():
+            pos += 1
+        yield data[start:pos], pos
+
+
+def read_pbm(data):
+    """Reads a PBM (P1 or P4) image.
+
+    Returns the width, height and a list of rows, each a list of 0 or 1 per pixel, where 1 is black.
+    """
+    tokens = _pbm_tokens(data)
+    try:
+        magic = next(tokens)[0]
+        width = int(next(tokens)[0])
+        height, pos = next(tokens)
+        height = int(height)
+    except (StopIteration, ValueError):
+        raise ImageError('Not a PBM image')
+
+    if magic == b'P1':
+        bits = [int(c) for c in data[pos:].decode('ascii') if c in '01']
+        if len(bits) < width * height:
+            raise ImageError('PBM image is truncated')
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+
+    elif magic == b'P4':
+        pos += 1  # A single whitespace separates the header from the pixels
+        stride = (width + 7) // 8
+        if len(data) < pos + stride * height:
+            raise ImageError('PBM image is truncated')
+        rows = []
+        for y in range(height):
+            row = data[pos + y * stride:pos + (y + 1) * stride]
+            rows.append([(row[x // 8] >> (7 - x % 8)) & 1 for x in range(width)])
+
+    else:
+        raise ImageError('Only P1 and P4 PBM images are supported')
+
+    return width, height, rows
+
+
+def image2oled(width, height, rows, invert=False):
+    """Lays out an image the way the OLED buffer is, a byte for each column of 8 pixels, a page at a time.
+
+    Black pixels are lit, unless invert is set. The height is padded to a whole number of pages.
+    """
+    pages = (height + 7) // 8
+    data = bytearray(width * pages)
+
+    for y in range(height):
+        for x in range(width):
+            if bool(rows[y][x]) != invert:
+                data[(y // 8) * width + x] |= 1 << (y % 8)
+
+    return bytes(data)
+
+
+def encode(width, pages, data, previous=None):
+    """Compresses one image, laid out by image2oled().
+
+    With previous, the image before it in an animation, bytes that don't change are skipped.
+    """
+    out = bytearray([width, pages])
+    literal = bytearray()
+
+    def flush():
+        if literal:
+            out.append(len(literal) - 1)
+            out.extend(literal)
+            literal.clear()
+
+    i = 0
+    while i < len(data):
+        # Unchanged bytes, a single one is cheaper to send within a literal
+        if previous is not None:
+            skip = 0
+            while i + skip < len(data) and skip < MAX_SKIP and data[i + skip] == previous[i + skip]:
+                skip += 1
+            if skip >= 2 or (skip and not literal):
+                flush()
+                out.append(OLED_IMAGE_SKIP | (skip - 1))
+                i += skip
+                continue
+
+        repeat = 1
+        while i + repeat < len(data) and repeat < MAX_REPEAT and data[i + repeat] == data[i]:
+            repeat += 1
+        if repeat >= 3 or (repeat == 2 and not literal):
+            flush()
+            out.append(OLED_IMAGE_REPEAT | (repeat - 2))
+            out.append(data[i])
+            i += repeat
+            continue
+
+        literal.append(data[i])
+        if len(literal) == MAX_LITERAL:
+            flush()
+        i += 1
+
+    flush()
+    return bytes(out)
+
+
+def decode(image, screen):
+    """Draws a compressed image over screen, a bytearray laid out like the image, as the firmware does.
+    """
+    width, pages = image[0], image[1]
+    length = width * pages
+    pos = 0
+    i = 2
+
+    while pos < length:
+        op = image[i]
+        i += 1
+        if op >= OLED_IMAGE_SKIP:
+            pos += (op & 0x3F) + 1
+        elif op >= OLED_IMAGE_REPEAT:
+            count = min((op & 0x3F) + 2, length - pos)
+            screen[pos:pos + count] = bytes([image[i]]) * count
+            pos += count
+            i += 1
+        else:
+            count = min(op + 1, length - pos)
+            screen[pos:pos + count] = image[i:i + count]
+            pos += count
+            i += op + 1
+
+    return screen
+
+
+def encode_frames(width, pages, frames):
+    """Compresses the frames of an animation, the first whole and the rest as changes from the frame before.
+    """
+    previous = None
+    encoded = []
+
+    for frame in frames:
+        encoded.append(encode(width, pages, frame, previous))
+        previous = frame
+
+    return encoded
+
+
+def to_c(name, encoded):
+    """Returns C source declaring the compressed frames, and a table of them when there is more than one.
+    """
+    lines = []
+
+    for index, image in enumerate(encoded):
+        array = name if len(encoded) == 1 else '%s_%d' % (name, index)
+        lines.append('// %d bytes' % len(image))
+        lines.append('static const uint8_t PROGMEM %s[] = {' % array)
+        for start in range(0, len(image), 16):
+            lines.append('    ' + ', '.join('0x%02x' % b for b in image[start:start + 16]) + ',')
+        lines.append('};')
+        lines.append('')
+
+    if len(encoded) > 1:
+        lines.append('static const uint8_t *const PROGMEM %s[] = {' % name)
+        for index in range(len(encoded)):
+            lines.append('    %s_%d,' % (name, index))
+        lines.append('};')
+        lines.append('')
+
+    return '\n'.join(lines)
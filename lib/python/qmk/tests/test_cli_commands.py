@@ -54,3 +54,9 @@ def test_list_keyboards():
     # check to see if a known keyboard is returned
     # this will fail if handwired/onekey/pytest is removed
     assert 'handwired/onekey/pytest' in result.stdout
+
+
+def test_oled_image():
+    result = check_subcommand('oled-image', 'lib/python/qmk/tests/oled.pbm')
+    assert result.returncode == 0
+    assert 'static const uint8_t PROGMEM oled[] = {' in result.stdout
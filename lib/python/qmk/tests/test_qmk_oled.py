@@ -0,0 +1,49 @@
+import random
+
+import qmk.oled
+
+P4_2X9 = b'P4\n# comment\n2 9\n' + bytes([0x80, 0x40, 0x80, 0x40, 0x80, 0x40, 0x80, 0x40, 0xC0])
+
+
+def test_read_pbm_p4():
+    width, height, rows = qmk.oled.read_pbm(P4_2X9)
+    assert (width, height) == (2, 9)
+    assert rows[0] == [1, 0]
+    assert rows[1] == [0, 1]
+    assert rows[8] == [1, 1]
+
+
+def test_image2oled():
+    data = qmk.oled.image2oled(*qmk.oled.read_pbm(P4_2X9))
+    assert data == bytes([0x55, 0xAA, 0x01, 0x01])
+    assert qmk.oled.image2oled(*qmk.oled.read_pbm(P4_2X9), invert=True) == bytes([0xAA, 0x55, 0x00, 0x00])
+
+
+def test_encode_runs():
+    data = bytes([0] * 100 + [1, 2, 3])
+    image = qmk.oled.encode(103, 1, data)
+    assert image == bytes([103, 1, 0x80 | 63, 0, 0x80 | 33, 0, 2, 1, 2, 3])
+    assert qmk.oled.decode(image, bytearray(103)) == data
+
+
+def test_encode_skips_unchanged_bytes():
+    previous = bytes(range(64))
+    data = bytearray(previous)
+    data[40] = 0xFF
+    image = qmk.oled.encode(64, 1, bytes(data), previous)
+    assert image == bytes([64, 1, 0xC0 | 39, 0x00, 0xFF, 0xC0 | 22])
+    assert qmk.oled.decode(image, bytearray(previous)) == data
+
+
+def test_frames_round_trip():
+    rand = random.Random(0)
+    frame = bytearray(128 * 4)
+    frames = []
+    for _ in range(8):
+        for _ in range(rand.randrange(1, 40)):
+            frame[rand.randrange(len(frame))] = rand.randrange(256)
+        frames.append(bytes(frame))
+
+    screen = bytearray(128 * 4)
+    for data, image in zip(frames, qmk.oled.encode_frames(128, 4, frames)):
+        assert qmk.oled.decode(image, screen) == data
@@ -84,6 +84,10 @@ void decrease_tempo(uint8_t tempo_change);
 
 void audio_init(void);
 
+#ifdef AUDIO_DRIVER_WAVETABLE
+void audio_task(void);
+#endif
+
 #ifdef PWM_AUDIO
 void play_sample(uint8_t* s, uint16_t l, bool r);
 #endif
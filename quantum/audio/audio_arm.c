@@ -15,6 +15,7 @@
  */
 
 #include "audio.h"
+#include "audio_benchmark.h"
 #include "ch.h"
 #include "hal.h"
 
@@ -79,6 +80,17 @@ float startup_song[][2] = STARTUP_SONG;
 
 static void gpt_cb8(GPTDriver *gptp);
 
+#ifdef AUDIO_BENCHMARK
+static void gpt_cb8_benchmark(GPTDriver *gptp) {
+    AUDIO_BENCHMARK_START();
+    gpt_cb8(gptp);
+    AUDIO_BENCHMARK_END();
+}
+#    define GPT8_CALLBACK gpt_cb8_benchmark
+#else
+#    define GPT8_CALLBACK gpt_cb8
+#endif
+
 #define DAC_BUFFER_SIZE 100
 #ifndef DAC_SAMPLE_MAX
 #    define DAC_SAMPLE_MAX 65535U
@@ -128,7 +140,7 @@ GPTConfig gpt7cfg1 = {.frequency = 440U * DAC_BUFFER_SIZE,
                       .dier      = 0U};
 
 GPTConfig gpt8cfg1 = {.frequency = 10,
-                      .callback  = gpt_cb8,
+                      .callback  = GPT8_CALLBACK,
                       .cr2       = TIM_CR2_MMS_1, /* MMS = 010 = TRGO on Update Event.    */
                       .dier      = 0U};
 
@@ -270,6 +282,10 @@ void audio_init() {
 #    endif
 #endif  // ARM EEPROM
 
+#ifdef AUDIO_BENCHMARK
+    audio_benchmark_init();
+#endif
+
     /*
      * Starting DAC1 driver, setting up the output pin as analog as suggested
      * by the Reference Manual.
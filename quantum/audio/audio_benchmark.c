@@ -0,0 +1,66 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audio_benchmark.h"
+
+#ifdef AUDIO_BENCHMARK
+
+#    include "print.h"
+#    include "timer.h"
+
+// Written from the audio interrupt, read and reset by audio_benchmark_task()
+static volatile uint32_t benchmark_calls  = 0;
+static volatile uint32_t benchmark_cycles = 0;
+static volatile uint32_t benchmark_max    = 0;
+
+static uint16_t benchmark_timer = 0;
+
+void audio_benchmark_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    benchmark_timer = timer_read();
+}
+
+void audio_benchmark_add(uint32_t cycles) {
+    benchmark_calls++;
+    benchmark_cycles += cycles;
+    if (cycles > benchmark_max) {
+        benchmark_max = cycles;
+    }
+}
+
+void audio_benchmark_task(void) {
+    if (timer_elapsed(benchmark_timer) < AUDIO_BENCHMARK_INTERVAL) {
+        return;
+    }
+    benchmark_timer += AUDIO_BENCHMARK_INTERVAL;
+
+    chSysLock();
+    uint32_t calls  = benchmark_calls;
+    uint32_t cycles = benchmark_cycles;
+    uint32_t max    = benchmark_max;
+    benchmark_calls  = 0;
+    benchmark_cycles = 0;
+    benchmark_max    = 0;
+    chSysUnlock();
+
+    if (calls) {
+        dprintf("audio isr: %lu calls, %lu cycles in total, %lu average, %lu max\n", calls, cycles, cycles / calls, max);
+    }
+}
+
+#endif
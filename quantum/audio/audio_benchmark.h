@@ -0,0 +1,51 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIO_BENCHMARK_H
+#define AUDIO_BENCHMARK_H
+
+#include <stdint.h>
+
+// Measures the CPU time the ARM audio drivers spend in their interrupts,
+// with the DWT cycle counter of Cortex-M3/M4/M7 cores.
+//
+// #define AUDIO_BENCHMARK
+
+#ifdef AUDIO_BENCHMARK
+
+#    include "ch.h"
+#    include "hal.h"
+
+// How often audio_benchmark_task() prints the results
+#    ifndef AUDIO_BENCHMARK_INTERVAL
+#        define AUDIO_BENCHMARK_INTERVAL 1000
+#    endif
+
+void audio_benchmark_init(void);
+void audio_benchmark_add(uint32_t cycles);
+void audio_benchmark_task(void);
+
+#    define AUDIO_BENCHMARK_START() uint32_t audio_benchmark_start = DWT->CYCCNT
+#    define AUDIO_BENCHMARK_END() audio_benchmark_add(DWT->CYCCNT - audio_benchmark_start)
+
+#else
+
+#    define AUDIO_BENCHMARK_START()
+#    define AUDIO_BENCHMARK_END()
+
+#endif
+
+#endif
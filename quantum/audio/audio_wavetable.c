@@ -0,0 +1,474 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Wavetable audio for the ARM DAC.
+ *
+ * Every sounding note is a voice with a 32 bit phase accumulator, stepped by a
+ * fixed point increment once per sample and looked up in a wavetable. The
+ * voices are mixed into one half of a circular DMA buffer while the DAC plays
+ * the other half, so the interrupt only refills buffers with integer math.
+ * Songs, envelopes, vibrato and glissando run from audio_task(), which works
+ * out the increments for the mixer. The mixer and song stepping themselves
+ * are in wavetable.c.
+ */
+
+#include "audio.h"
+#include "audio_benchmark.h"
+#include "wavetable.h"
+#include "ch.h"
+#include "hal.h"
+
+#include <string.h>
+#include "print.h"
+#include "keymap.h"
+#include "timer.h"
+
+#include "eeconfig.h"
+
+// -----------------------------------------------------------------------------
+
+// Samples in the DMA buffer, half of it is refilled at a time
+#ifndef AUDIO_WAVETABLE_BUFFER_SIZE
+#    define AUDIO_WAVETABLE_BUFFER_SIZE 256
+#endif
+
+#if AUDIO_WAVETABLE_BUFFER_SIZE % 2
+#    error "AUDIO_WAVETABLE_BUFFER_SIZE must be even"
+#endif
+
+// -----------------------------------------------------------------------------
+
+int   voices        = 0;
+float frequency     = 0;
+float frequency_alt = 0;
+
+float frequencies[AUDIO_VOICES_MAX] = {0};
+int   volumes[AUDIO_VOICES_MAX]     = {0};
+
+bool    playing_notes = false;
+bool    playing_note  = false;
+uint8_t note_tempo    = TEMPO_DEFAULT;
+float   note_timbre   = TIMBRE_DEFAULT;
+
+static wavetable_song_t song;
+
+#ifdef VIBRATO_ENABLE
+float vibrato_counter  = 0;
+float vibrato_strength = .5;
+float vibrato_rate     = 0.125;
+#endif
+
+// All voices are always mixed, this is only kept for voices.c and the API
+float polyphony_rate = 0;
+
+static bool audio_initialized = false;
+
+audio_config_t audio_config;
+
+uint16_t envelope_index = 0;
+bool     glissando      = true;
+
+static uint16_t audio_tick_timer = 0;
+
+#ifndef STARTUP_SONG
+#    define STARTUP_SONG SONG(STARTUP_SOUND)
+#endif
+float startup_song[][2] = STARTUP_SONG;
+
+// -----------------------------------------------------------------------------
+
+// Only changed with the system locked, the interrupt mixes it
+static wavetable_mixer_t mixer = {.duty = 0x80000000};
+
+static dacsample_t dac_buffer[AUDIO_WAVETABLE_BUFFER_SIZE];
+static dacsample_t dac_buffer_2[AUDIO_WAVETABLE_BUFFER_SIZE];
+
+/*
+ * DAC streaming callback, called when either half of the buffer has been played.
+ * DACD2 is triggered by the same timer, so it is at the same place in its buffer.
+ */
+static void end_cb1(DACDriver *dacp, dacsample_t *buffer, size_t n) {
+    (void)dacp;
+
+    AUDIO_BENCHMARK_START();
+    wavetable_mix(&mixer, buffer, dac_buffer_2 + (buffer - dac_buffer), n);
+    AUDIO_BENCHMARK_END();
+}
+
+/*
+ * DAC error callback.
+ */
+static void error_cb1(DACDriver *dacp, dacerror_t err) {
+    (void)dacp;
+    (void)err;
+
+    chSysHalt("DAC failure");
+}
+
+static const DACConfig dac1cfg1 = {.init = AUDIO_SAMPLE_MID, .datamode = DAC_DHRM_12BIT_RIGHT};
+
+static const DACConversionGroup dacgrpcfg1 = {.num_channels = 1U, .end_cb = end_cb1, .error_cb = error_cb1, .trigger = DAC_TRG(0)};
+
+static const DACConfig dac1cfg2 = {.init = AUDIO_SAMPLE_MID, .datamode = DAC_DHRM_12BIT_RIGHT};
+
+static const DACConversionGroup dacgrpcfg2 = {.num_channels = 1U, .end_cb = NULL, .error_cb = error_cb1, .trigger = DAC_TRG(0)};
+
+/*
+ * GPT6 triggers both DACs once per sample.
+ */
+static const GPTConfig gpt6cfg1 = {.frequency = AUDIO_WAVETABLE_SAMPLE_RATE * 2,
+                                   .callback  = NULL,
+                                   .cr2       = TIM_CR2_MMS_1, /* MMS = 010 = TRGO on Update Event.    */
+                                   .dier      = 0U};
+
+// -----------------------------------------------------------------------------
+
+#ifdef VIBRATO_ENABLE
+
+float mod(float a, int b) {
+    float r = fmod(a, b);
+    return r < 0 ? r + b : r;
+}
+
+float vibrato(float average_freq) {
+#    ifdef VIBRATO_STRENGTH_ENABLE
+    float vibrated_freq = average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
+#    else
+    float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
+#    endif
+    vibrato_counter = mod((vibrato_counter + vibrato_rate * (1.0 + 440.0 / average_freq)), VIBRATO_LUT_LENGTH);
+    return vibrated_freq;
+}
+
+#endif
+
+// Slides the sounding frequency a quarter tone per tick towards the target
+static float glide(float current, float target) {
+    if (!glissando || current == 0) {
+        return target;
+    }
+    if (current < target / 1.0293022f) {
+        return current * 1.0293022f;
+    }
+    if (current > target * 1.0293022f) {
+        return current / 1.0293022f;
+    }
+    return target;
+}
+
+// Works out the wave of a voice and its increment, 0 for silence
+static uint32_t audio_increment(float freq) {
+    if (freq < AUDIO_MIN_FREQUENCY) {
+        return 0;
+    }
+#ifdef VIBRATO_ENABLE
+    if (vibrato_strength > 0) {
+        freq = vibrato(freq);
+    }
+#endif
+    return wavetable_increment(voice_envelope(freq));
+}
+
+// Hands what should be sounding now to the mixer
+static void audio_update(void) {
+    uint32_t increments[AUDIO_VOICES_MAX];
+    uint8_t  count = 0;
+
+    if (playing_notes) {
+        frequency = song.frequency < AUDIO_MIN_FREQUENCY ? 0 : glide(frequency, song.frequency);
+        if ((increments[count] = audio_increment(frequency))) {
+            count++;
+        }
+    } else if (playing_note && voices > 0) {
+        // Glissando is for the newest note, the others are held
+        for (int i = 0; i < voices - 1; i++) {
+            if ((increments[count] = audio_increment(frequencies[i]))) {
+                count++;
+            }
+        }
+        frequency = glide(frequency, frequencies[voices - 1]);
+        if ((increments[count] = audio_increment(frequency))) {
+            count++;
+        }
+    }
+
+    uint32_t duty = (uint32_t)(note_timbre * 4294967295.0f);
+
+    chSysLock();
+    wavetable_mixer_set(&mixer, increments, count, duty);
+    chSysUnlock();
+}
+
+void audio_task(void) {
+    if (!audio_initialized || timer_elapsed(audio_tick_timer) < AUDIO_WAVETABLE_TICK) {
+        return;
+    }
+    audio_tick_timer = timer_read();
+
+    if (!audio_config.enable) {
+        playing_notes = false;
+        playing_note  = false;
+    }
+    if (!playing_notes && !playing_note) {
+        if (mixer.voices) {
+            audio_update();
+        }
+        return;
+    }
+
+    if (envelope_index < 65535) {
+        envelope_index++;
+    }
+    if (playing_notes) {
+        bool resting = song.resting;
+        if (!wavetable_song_tick(&song, note_tempo)) {
+            playing_notes = false;
+        } else if (resting && !song.resting) {
+            envelope_index = 0;
+        }
+    }
+    audio_update();
+}
+
+// -----------------------------------------------------------------------------
+
+void audio_init() {
+    if (audio_initialized) {
+        return;
+    }
+
+// Check EEPROM
+#ifdef EEPROM_ENABLE
+    if (!eeconfig_is_enabled()) {
+        eeconfig_init();
+    }
+    audio_config.raw = eeconfig_read_audio();
+#else  // ARM EEPROM
+    audio_config.enable        = true;
+#    ifdef AUDIO_CLICKY_ON
+    audio_config.clicky_enable = true;
+#    endif
+#endif  // ARM EEPROM
+
+#ifdef AUDIO_BENCHMARK
+    audio_benchmark_init();
+#endif
+
+    for (uint16_t i = 0; i < AUDIO_WAVETABLE_BUFFER_SIZE; i++) {
+        dac_buffer[i]   = AUDIO_SAMPLE_MID;
+        dac_buffer_2[i] = AUDIO_SAMPLE_MID;
+    }
+
+    /*
+     * Starting DAC1 driver, setting up the output pin as analog as suggested
+     * by the Reference Manual.
+     */
+    palSetPadMode(GPIOA, 4, PAL_MODE_INPUT_ANALOG);
+    palSetPadMode(GPIOA, 5, PAL_MODE_INPUT_ANALOG);
+    dacStart(&DACD1, &dac1cfg1);
+    dacStart(&DACD2, &dac1cfg2);
+
+    /*
+     * Starting both conversions before the timer that triggers them, so they
+     * stay in step.
+     */
+    dacStartConversion(&DACD1, &dacgrpcfg1, dac_buffer, AUDIO_WAVETABLE_BUFFER_SIZE);
+    dacStartConversion(&DACD2, &dacgrpcfg2, dac_buffer_2, AUDIO_WAVETABLE_BUFFER_SIZE);
+    gptStart(&GPTD6, &gpt6cfg1);
+    gptStartContinuous(&GPTD6, 2U);
+
+    audio_tick_timer  = timer_read();
+    audio_initialized = true;
+
+    if (audio_config.enable) {
+        PLAY_SONG(startup_song);
+    } else {
+        stop_all_notes();
+    }
+}
+
+void stop_all_notes() {
+    dprintf("audio stop all notes");
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    voices = 0;
+
+    playing_notes = false;
+    playing_note  = false;
+    frequency     = 0;
+    frequency_alt = 0;
+
+    for (uint8_t i = 0; i < AUDIO_VOICES_MAX; i++) {
+        frequencies[i] = 0;
+        volumes[i]     = 0;
+    }
+    audio_update();
+}
+
+void stop_note(float freq) {
+    dprintf("audio stop note freq=%d", (int)freq);
+
+    if (playing_note) {
+        if (!audio_initialized) {
+            audio_init();
+        }
+        for (int i = voices - 1; i >= 0; i--) {
+            if (frequencies[i] == freq) {
+                for (int j = i; j < voices - 1; j++) {
+                    frequencies[j] = frequencies[j + 1];
+                    volumes[j]     = volumes[j + 1];
+                }
+                voices--;
+                frequencies[voices] = 0;
+                volumes[voices]     = 0;
+                break;
+            }
+        }
+        if (voices == 0) {
+            frequency    = 0;
+            playing_note = false;
+        }
+        audio_update();
+    }
+}
+
+void play_note(float freq, int vol) {
+    dprintf("audio play note freq=%d vol=%d", (int)freq, vol);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable && voices < AUDIO_VOICES_MAX) {
+        // Cancel notes if notes are playing
+        if (playing_notes) {
+            stop_all_notes();
+        }
+
+        playing_note = true;
+
+        envelope_index = 0;
+
+        if (freq > 0) {
+            frequencies[voices] = freq;
+            volumes[voices]     = vol;
+            voices++;
+        }
+        audio_update();
+    }
+}
+
+void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        // Cancel note if a note is playing
+        if (playing_note) {
+            stop_all_notes();
+        }
+
+        playing_notes = true;
+
+        wavetable_song_start(&song, np, n_count, n_repeat, note_tempo);
+
+        envelope_index = 0;
+        frequency      = 0;
+
+        audio_tick_timer = timer_read();
+        audio_update();
+    }
+}
+
+bool is_playing_notes(void) { return playing_notes; }
+
+bool is_audio_on(void) { return (audio_config.enable != 0); }
+
+void audio_toggle(void) {
+    audio_config.enable ^= 1;
+    eeconfig_update_audio(audio_config.raw);
+    if (audio_config.enable) {
+        audio_on_user();
+    }
+}
+
+void audio_on(void) {
+    audio_config.enable = 1;
+    eeconfig_update_audio(audio_config.raw);
+    audio_on_user();
+}
+
+void audio_off(void) {
+    stop_all_notes();
+    audio_config.enable = 0;
+    eeconfig_update_audio(audio_config.raw);
+}
+
+#ifdef VIBRATO_ENABLE
+
+// Vibrato rate functions
+
+void set_vibrato_rate(float rate) { vibrato_rate = rate; }
+
+void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+
+void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+
+#    ifdef VIBRATO_STRENGTH_ENABLE
+
+void set_vibrato_strength(float strength) { vibrato_strength = strength; }
+
+void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+
+void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+
+#    endif /* VIBRATO_STRENGTH_ENABLE */
+
+#endif /* VIBRATO_ENABLE */
+
+// Polyphony functions
+
+void set_polyphony_rate(float rate) { polyphony_rate = rate; }
+
+void enable_polyphony() { polyphony_rate = 5; }
+
+void disable_polyphony() { polyphony_rate = 0; }
+
+void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+
+void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+
+// Timbre function
+
+void set_timbre(float timbre) { note_timbre = timbre; }
+
+// Tempo functions
+
+void set_tempo(uint8_t tempo) { note_tempo = tempo; }
+
+void decrease_tempo(uint8_t tempo_change) { note_tempo += tempo_change; }
+
+void increase_tempo(uint8_t tempo_change) {
+    if (note_tempo - tempo_change < 10) {
+        note_tempo = 10;
+    } else {
+        note_tempo -= tempo_change;
+    }
+}
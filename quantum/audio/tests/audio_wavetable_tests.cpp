@@ -0,0 +1,149 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+extern "C" {
+#include "wavetable.h"
+#include "musical_notes.h"
+}
+
+// The driver refills half of its buffer at a time
+#define HALF_BUFFER 128
+
+class AudioWavetable : public testing::Test {
+   public:
+    AudioWavetable() : mixer() { mixer.duty = 0x80000000; }
+
+    void play(const float *freqs, uint8_t count) {
+        uint32_t increments[AUDIO_VOICES_MAX];
+        for (uint8_t v = 0; v < count; v++) {
+            increments[v] = wavetable_increment(freqs[v]);
+        }
+        wavetable_mixer_set(&mixer, increments, count, mixer.duty);
+    }
+
+    void mix(size_t n) {
+        out.resize(n);
+        inverted.resize(n);
+        for (size_t i = 0; i < n; i += HALF_BUFFER) {
+            wavetable_mix(&mixer, &out[i], &inverted[i], std::min<size_t>(HALF_BUFFER, n - i));
+        }
+    }
+
+    // Plays a whole song, returning how long it lasted in ms
+    uint32_t song_length(float (*notes)[][2], uint16_t count) {
+        wavetable_song_start(&song, notes, count, false, TEMPO_DEFAULT);
+        uint32_t ms = AUDIO_WAVETABLE_TICK;
+        while (wavetable_song_tick(&song, TEMPO_DEFAULT)) {
+            ms += AUDIO_WAVETABLE_TICK;
+        }
+        return ms;
+    }
+
+    wavetable_mixer_t     mixer;
+    wavetable_song_t      song;
+    std::vector<uint16_t> out;
+    std::vector<uint16_t> inverted;
+};
+
+static uint32_t ticks_ms(uint32_t ms) { return (ms + AUDIO_WAVETABLE_TICK - 1) / AUDIO_WAVETABLE_TICK * AUDIO_WAVETABLE_TICK; }
+
+TEST_F(AudioWavetable, plays_a_note_at_its_frequency) {
+    const float freqs[] = {440.0f};
+    play(freqs, 1);
+    mix(AUDIO_WAVETABLE_SAMPLE_RATE);
+
+    int crossings = 0;
+    for (size_t i = 1; i < out.size(); i++) {
+        if ((out[i - 1] > AUDIO_SAMPLE_MID) != (out[i] > AUDIO_SAMPLE_MID)) {
+            crossings++;
+        }
+    }
+    EXPECT_NEAR(crossings, 880, 1);
+}
+
+TEST_F(AudioWavetable, a_chord_stays_in_range) {
+    const float freqs[AUDIO_VOICES_MAX] = {NOTE_C4, NOTE_E4, NOTE_G4, NOTE_C5, NOTE_E5, NOTE_G5, NOTE_C6, NOTE_E6};
+    play(freqs, AUDIO_VOICES_MAX);
+    mix(AUDIO_WAVETABLE_SAMPLE_RATE / 10);
+
+    uint16_t lowest = AUDIO_SAMPLE_MAX, highest = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        ASSERT_LE(out[i], AUDIO_SAMPLE_MAX);
+        ASSERT_EQ(out[i] + inverted[i], 2 * AUDIO_SAMPLE_MID);
+        lowest  = std::min(lowest, out[i]);
+        highest = std::max(highest, out[i]);
+    }
+    // All voices in step use most of the range
+    EXPECT_LT(lowest, AUDIO_SAMPLE_MAX / 16);
+    EXPECT_GT(highest, AUDIO_SAMPLE_MAX - AUDIO_SAMPLE_MAX / 16);
+}
+
+TEST_F(AudioWavetable, silence_is_the_midpoint) {
+    const float freqs[] = {440.0f};
+    play(freqs, 1);
+    mix(HALF_BUFFER);
+    play(freqs, 0);
+    mix(HALF_BUFFER);
+
+    for (size_t i = 0; i < out.size(); i++) {
+        ASSERT_EQ(out[i], AUDIO_SAMPLE_MID);
+        ASSERT_EQ(inverted[i], AUDIO_SAMPLE_MID);
+    }
+}
+
+TEST_F(AudioWavetable, rests_are_silent) {
+    EXPECT_EQ(wavetable_increment(NOTE_REST), 0u);
+}
+
+TEST_F(AudioWavetable, a_song_lasts_its_notes) {
+    float notes[][2] = SONG(QUARTER_NOTE(_A4), EIGHTH_NOTE(_C5), HALF_NOTE(_E5));
+
+    uint32_t expected = 0;
+    for (auto &note : notes) {
+        expected += ticks_ms(AUDIO_NOTE_MS(note[1], TEMPO_DEFAULT)) + ticks_ms(AUDIO_NOTE_MS(4, TEMPO_DEFAULT));
+    }
+    EXPECT_EQ(song_length(&notes, 3), expected);
+    // A quarter note is 131 ms at the default tempo, as on AVR
+    EXPECT_NEAR(expected, (16 + 8 + 32 + 3 * 4) * 8.192, 6 * AUDIO_WAVETABLE_TICK);
+}
+
+TEST_F(AudioWavetable, repeated_notes_are_heard_apart) {
+    float notes[][2] = SONG(EIGHTH_NOTE(_A4), EIGHTH_NOTE(_A4));
+    wavetable_song_start(&song, &notes, 2, false, TEMPO_DEFAULT);
+
+    EXPECT_EQ(song.frequency, NOTE_A4);
+    while (!song.resting) {
+        ASSERT_TRUE(wavetable_song_tick(&song, TEMPO_DEFAULT));
+    }
+    EXPECT_EQ(song.frequency, 0.0f);
+    while (song.resting) {
+        ASSERT_TRUE(wavetable_song_tick(&song, TEMPO_DEFAULT));
+    }
+    EXPECT_EQ(song.frequency, NOTE_A4);
+}
+
+TEST_F(AudioWavetable, a_repeating_song_starts_again) {
+    float notes[][2] = SONG(EIGHTH_NOTE(_A4), EIGHTH_NOTE(_C5));
+    wavetable_song_start(&song, &notes, 2, true, TEMPO_DEFAULT);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(wavetable_song_tick(&song, TEMPO_DEFAULT));
+    }
+    EXPECT_LT(song.current, 2);
+}
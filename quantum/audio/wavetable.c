@@ -0,0 +1,114 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable.h"
+
+#ifdef AUDIO_WAVETABLE_SINE
+#    include "wave.h"
+#endif
+
+// Phase increment per Hz, a whole wave is 2^32
+#define AUDIO_PHASE_PER_HZ (4294967296.0f / AUDIO_WAVETABLE_SAMPLE_RATE)
+
+uint32_t wavetable_increment(float freq) {
+    if (freq < AUDIO_MIN_FREQUENCY) {
+        return 0;
+    }
+    return (uint32_t)(freq * AUDIO_PHASE_PER_HZ);
+}
+
+void wavetable_mixer_set(wavetable_mixer_t *mixer, const uint32_t *increments, uint8_t count, uint32_t duty) {
+    for (uint8_t v = 0; v < count; v++) {
+        if (v >= mixer->voices) {
+            mixer->phase[v] = 0;
+        }
+        mixer->increment[v] = increments[v];
+    }
+    mixer->voices = count;
+    mixer->gain   = count ? (int32_t)(AUDIO_SAMPLE_MID * 65536UL / (128UL * count)) : 0;
+    mixer->duty   = duty;
+}
+
+static inline int32_t wavetable_sample(const wavetable_mixer_t *mixer, uint32_t phase) {
+#ifdef AUDIO_WAVETABLE_SINE
+    return (int32_t)sinewave[phase >> 21] - 128;
+#else
+    return phase < mixer->duty ? 127 : -127;
+#endif
+}
+
+void wavetable_mix(wavetable_mixer_t *mixer, uint16_t *out, uint16_t *out_inverted, size_t n) {
+    if (mixer->voices == 0) {
+        for (size_t i = 0; i < n; i++) {
+            out[i]          = AUDIO_SAMPLE_MID;
+            out_inverted[i] = AUDIO_SAMPLE_MID;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        int32_t sum = 0;
+        for (uint8_t v = 0; v < mixer->voices; v++) {
+            mixer->phase[v] += mixer->increment[v];
+            sum += wavetable_sample(mixer, mixer->phase[v]);
+        }
+        int32_t sample  = (sum * mixer->gain) >> 16;
+        out[i]          = AUDIO_SAMPLE_MID + sample;
+        out_inverted[i] = AUDIO_SAMPLE_MID - sample;
+    }
+}
+
+void wavetable_song_start(wavetable_song_t *song, float (*notes)[][2], uint16_t count, bool repeat, uint8_t tempo) {
+    song->notes     = notes;
+    song->count     = count;
+    song->repeat    = repeat;
+    song->current   = 0;
+    song->resting   = false;
+    song->frequency = (*notes)[0][0];
+    song->length    = AUDIO_NOTE_MS((*notes)[0][1], tempo);
+    song->position  = 0;
+}
+
+bool wavetable_song_tick(wavetable_song_t *song, uint8_t tempo) {
+    song->position += AUDIO_WAVETABLE_TICK;
+    if (song->position < song->length) {
+        return true;
+    }
+
+    if (!song->resting) {
+        // A short rest after each note, silent when the next note is the
+        // same so that they are heard apart
+        uint16_t next = song->current + 1 < song->count ? song->current + 1 : 0;
+        if ((*song->notes)[next][0] == song->frequency) {
+            song->frequency = 0;
+        }
+        song->resting = true;
+        song->length  = AUDIO_NOTE_MS(4, tempo);
+    } else {
+        song->current++;
+        if (song->current >= song->count) {
+            if (!song->repeat) {
+                return false;
+            }
+            song->current = 0;
+        }
+        song->resting   = false;
+        song->frequency = (*song->notes)[song->current][0];
+        song->length    = AUDIO_NOTE_MS((*song->notes)[song->current][1], tempo);
+    }
+    song->position = 0;
+    return true;
+}
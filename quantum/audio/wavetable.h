@@ -0,0 +1,96 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Mixing and song stepping for the wavetable audio driver. Nothing here
+// touches the hardware, so it also builds and is tested on the host.
+
+#ifndef AUDIO_WAVETABLE_SAMPLE_RATE
+#    define AUDIO_WAVETABLE_SAMPLE_RATE 32000
+#endif
+
+// How often songs, envelopes, vibrato and glissando are stepped, in ms
+#ifndef AUDIO_WAVETABLE_TICK
+#    define AUDIO_WAVETABLE_TICK 4
+#endif
+
+#ifndef AUDIO_VOICES_MAX
+#    define AUDIO_VOICES_MAX 8
+#endif
+
+#ifndef DAC_SAMPLE_MAX
+#    define DAC_SAMPLE_MAX 65535U
+#endif
+
+// The DAC is 12 bit, DAC_SAMPLE_MAX only lowers the volume
+#if DAC_SAMPLE_MAX > 4095U
+#    define AUDIO_SAMPLE_MAX 4095U
+#else
+#    define AUDIO_SAMPLE_MAX DAC_SAMPLE_MAX
+#endif
+#define AUDIO_SAMPLE_MID (AUDIO_SAMPLE_MAX / 2)
+
+// Notes below this are rests, such as NOTE_REST
+#define AUDIO_MIN_FREQUENCY 30.52f
+
+// A note duration of 1 lasts 8.192 ms at TEMPO_DEFAULT, like on AVR
+#define AUDIO_NOTE_MS(duration, tempo) ((uint32_t)((duration) * (tempo)*8.192f / 100))
+
+// What the mixer plays. The phases belong to whoever calls wavetable_mix(),
+// the rest is only changed by wavetable_mixer_set().
+typedef struct {
+    uint32_t phase[AUDIO_VOICES_MAX];
+    uint32_t increment[AUDIO_VOICES_MAX];
+    uint8_t  voices;
+    uint32_t duty;
+    int32_t  gain;
+} wavetable_mixer_t;
+
+// Phase increment per sample for a frequency in Hz, a whole wave is 2^32
+uint32_t wavetable_increment(float freq);
+
+// Plays count voices, scaled so that together they fill the DAC range.
+// Voices that weren't playing start at the beginning of their wave. duty
+// is where square waves go low, as a fraction of 2^32.
+void wavetable_mixer_set(wavetable_mixer_t *mixer, const uint32_t *increments, uint8_t count, uint32_t duty);
+
+// Fills n samples of out, and of out_inverted with the inverted wave, with
+// integer math only
+void wavetable_mix(wavetable_mixer_t *mixer, uint16_t *out, uint16_t *out_inverted, size_t n);
+
+typedef struct {
+    float (*notes)[][2];
+    uint16_t count;
+    bool     repeat;
+    uint16_t current;
+    bool     resting;    // in the short rest after a note
+    float    frequency;  // to play now, 0 for silence
+    uint32_t length;     // of the note or rest, in ms
+    uint32_t position;
+} wavetable_song_t;
+
+void wavetable_song_start(wavetable_song_t *song, float (*notes)[][2], uint16_t count, bool repeat, uint8_t tempo);
+
+// Moves a song on by AUDIO_WAVETABLE_TICK ms, false when it has ended
+bool wavetable_song_tick(wavetable_song_t *song, uint8_t tempo);
+
+#endif
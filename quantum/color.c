@@ -18,10 +18,13 @@
 #include "led_tables.h"
 #include "progmem.h"
 
+// First hue of each sector, i.e. the smallest h with h * 6 / 255 == sector
+static const uint8_t hue_sector_start[] = {43, 85, 128, 170, 213, 255};
+
 RGB hsv_to_rgb(HSV hsv) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+    RGB     rgb;
+    uint8_t region, remainder, p, q, t;
+    uint8_t h, s, v;
 
     if (hsv.s == 0) {
 #ifdef USE_CIE1931_CURVE
@@ -42,12 +45,17 @@ RGB hsv_to_rgb(HSV hsv) {
     v = hsv.v;
 #endif
 
-    region    = h * 6 / 255;
+    // Same result as h * 6 / 255, without a division in the per LED path
+    region = 0;
+    while (region < sizeof(hue_sector_start) && h >= hue_sector_start[region]) {
+        region++;
+    }
     remainder = (h * 2 - region * 85) * 3;
 
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    // 8x8 bit multiplies, which AVR does in hardware
+    p = ((uint16_t)v * (uint8_t)(255 - s)) >> 8;
+    q = ((uint16_t)v * (uint8_t)(255 - (((uint16_t)s * remainder) >> 8))) >> 8;
+    t = ((uint16_t)v * (uint8_t)(255 - (((uint16_t)s * (uint8_t)(255 - remainder)) >> 8))) >> 8;
 
     switch (region) {
         case 6:
@@ -37,22 +37,38 @@ static pin_t encoders_pad_b[] = ENCODERS_PAD_B;
 
 static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
+// Only touched by encoder_step(), so from the interrupt with ENCODER_INTERRUPT
 static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
 static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
 
+// Detents counted up by encoder_step(), and how far encoder_read() got.
+// Each has a single writer and is a byte, so neither needs a lock.
+static volatile uint8_t encoder_detents[NUMBER_OF_ENCODERS]      = {0};
+static uint8_t          encoder_detents_read[NUMBER_OF_ENCODERS] = {0};
+
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
-static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
+static uint8_t  encoder_value[NUMBER_OF_ENCODERS * 2]     = {0};
+static uint32_t encoder_last_move[NUMBER_OF_ENCODERS * 2] = {0};
 // row offsets for each hand
 static uint8_t thisHand, thatHand;
 #else
-static uint8_t encoder_value[NUMBER_OF_ENCODERS] = {0};
+static uint8_t  encoder_value[NUMBER_OF_ENCODERS]     = {0};
+static uint32_t encoder_last_move[NUMBER_OF_ENCODERS] = {0};
 #endif
 
 __attribute__((weak)) void encoder_update_user(int8_t index, bool clockwise) {}
 
 __attribute__((weak)) void encoder_update_kb(int8_t index, bool clockwise) { encoder_update_user(index, clockwise); }
 
+__attribute__((weak)) bool encoder_moved_user(int8_t index, int8_t delta, uint16_t velocity) { return true; }
+
+__attribute__((weak)) bool encoder_moved_kb(int8_t index, int8_t delta, uint16_t velocity) { return encoder_moved_user(index, delta, velocity); }
+
+#if defined(ENCODER_INTERRUPT) && defined(PROTOCOL_CHIBIOS)
+static void encoder_pal_callback(void *arg) { encoder_interrupt((uintptr_t)arg); }
+#endif
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -70,6 +86,13 @@ void encoder_init(void) {
         setPinInputHigh(encoders_pad_b[i]);
 
         encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+
+#if defined(ENCODER_INTERRUPT) && defined(PROTOCOL_CHIBIOS)
+        palSetLineCallback(encoders_pad_a[i], encoder_pal_callback, (void *)(uintptr_t)i);
+        palSetLineCallback(encoders_pad_b[i], encoder_pal_callback, (void *)(uintptr_t)i);
+        palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+#endif
     }
 
 #ifdef SPLIT_KEYBOARD
@@ -78,28 +101,61 @@ void encoder_init(void) {
 #endif
 }
 
-static void encoder_update(int8_t index, uint8_t state) {
-    uint8_t i = index;
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
+// Samples the pins of an encoder, counting a detent every ENCODER_RESOLUTION pulses
+static void encoder_step(uint8_t i) {
+    encoder_state[i] <<= 2;
+    encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+    encoder_pulses[i] += encoder_LUT[encoder_state[i] & 0xF];
     if (encoder_pulses[i] >= ENCODER_RESOLUTION) {
-        encoder_value[index]++;
-        encoder_update_kb(index, true);
+        encoder_detents[i]++;
     }
     if (encoder_pulses[i] <= -ENCODER_RESOLUTION) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
-        encoder_update_kb(index, false);
+        encoder_detents[i]--;
     }
     encoder_pulses[i] %= ENCODER_RESOLUTION;
 }
 
+#ifdef ENCODER_INTERRUPT
+void encoder_interrupt(uint8_t index) { encoder_step(index); }
+#endif
+
+// Hands every detent an encoder moved since the last call to the callbacks at once
+static void encoder_moved(uint8_t index, int8_t delta) {
+    // Detents per second, from the time since it last moved
+    uint32_t elapsed  = timer_elapsed32(encoder_last_move[index]);
+    uint8_t  steps    = delta < 0 ? -delta : delta;
+    uint32_t velocity = elapsed >= 1000 ? steps : (uint32_t)steps * 1000 / (elapsed ? elapsed : 1);
+    if (velocity > UINT16_MAX) {
+        velocity = UINT16_MAX;
+    }
+    encoder_last_move[index] = timer_read32();
+
+    encoder_value[index] += delta;
+    if (encoder_moved_kb(index, delta, (uint16_t)velocity)) {
+        for (; delta > 0; delta--) {
+            encoder_update_kb(index, true);
+        }
+        for (; delta < 0; delta++) {
+            encoder_update_kb(index, false);
+        }
+    }
+}
+
 void encoder_read(void) {
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        encoder_state[i] <<= 2;
-        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        encoder_update(i, encoder_state[i]);
+#ifndef ENCODER_INTERRUPT
+        encoder_step(i);
+#endif
+        uint8_t detents = encoder_detents[i];
+        int8_t  delta   = detents - encoder_detents_read[i];
+        if (delta) {
+            encoder_detents_read[i] = detents;
+#ifdef SPLIT_KEYBOARD
+            encoder_moved(i + thisHand, delta);
+#else
+            encoder_moved(i, delta);
+#endif
+        }
     }
 }
 
@@ -110,15 +166,8 @@ void encoder_update_raw(uint8_t* slave_state) {
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
         uint8_t index = i + thatHand;
         int8_t  delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            encoder_update_kb(index, true);
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
-            encoder_update_kb(index, false);
+        if (delta) {
+            encoder_moved(index, delta);
         }
     }
 }
@@ -25,6 +25,17 @@ void encoder_read(void);
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
 
+// Called once a scan for each encoder that moved, with all the detents it moved
+// delta is positive clockwise, velocity is in detents per second
+// Return false to skip the encoder_update_kb() call for each detent
+bool encoder_moved_kb(int8_t index, int8_t delta, uint16_t velocity);
+bool encoder_moved_user(int8_t index, int8_t delta, uint16_t velocity);
+
+#ifdef ENCODER_INTERRUPT
+// Steps an encoder from the pin change interrupt of either of its pins
+void encoder_interrupt(uint8_t index);
+#endif
+
 #ifdef SPLIT_KEYBOARD
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
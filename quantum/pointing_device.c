@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "pointing_device.h"
+#include "mouse_accumulator.h"
 
 static report_mouse_t mouseReport = {};
 
@@ -31,7 +32,7 @@ __attribute__((weak)) void pointing_device_init(void) {
 
 __attribute__((weak)) void pointing_device_send(void) {
     // If you need to do other things, like debugging, this is the place to do it.
-    host_mouse_send(&mouseReport);
+    MOUSE_REPORT_SEND(MOUSE_SOURCE_POINTING_DEVICE, &mouseReport);
     // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
     mouseReport.x = 0;
     mouseReport.y = 0;
@@ -31,18 +31,125 @@ __attribute__((weak)) void leader_end(void) {}
 bool     leading     = false;
 uint16_t leader_time = 0;
 
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH] = {0};
+uint8_t  leader_sequence_size                    = 0;
+
+#    ifdef LEADER_SEQUENCE_COUNT
+#        if LEADER_SEQUENCE_COUNT > 255
+#            error "LEADER_SEQUENCE_COUNT can't be more than 255"
+#        endif
+
+// Range of leader_sequences[] that still match the keys typed so far.
+static uint8_t leader_match_first;
+static uint8_t leader_match_last;
+
+static inline uint16_t leader_sequence_key(uint8_t index, uint8_t position) { return pgm_read_word(&leader_sequences[index].keys[position]); }
+
+/* Whether the first candidate is exactly the sequence typed so far. Shorter
+ * sequences sort before their continuations, so only the first one can be.
+ */
+static bool leader_match_is_exact(void) {
+    if (leader_match_first == leader_match_last) return false;
+    return leader_sequence_size == LEADER_SEQUENCE_LENGTH || leader_sequence_key(leader_match_first, leader_sequence_size) == 0;
+}
+
+static void leader_finish(bool fire) {
+    void (*fn)(void) = NULL;
+
+    if (fire && leader_match_is_exact()) {
+        fn = (void (*)(void))pgm_read_ptr(&leader_sequences[leader_match_first].fn);
+    }
+    leading = false;
+    if (fn) {
+        fn();
+    }
+    leader_end();
+}
+
+/* Narrow the candidate range to the sequences whose key at the last typed
+ * position equals it, by binary search for both ends of the range.
+ */
+static void leader_match_key(uint16_t keycode) {
+    uint8_t position = leader_sequence_size - 1;
+    uint8_t first = leader_match_first, last = leader_match_last;
+
+    while (first < last) {
+        uint8_t mid = first + (last - first) / 2;
+        if (leader_sequence_key(mid, position) < keycode) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+    leader_match_first = first;
+
+    last = leader_match_last;
+    while (first < last) {
+        uint8_t mid = first + (last - first) / 2;
+        if (leader_sequence_key(mid, position) <= keycode) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+    leader_match_last = last;
+
+    if (leader_match_first == leader_match_last) {
+        // Nothing starts with this sequence
+        leader_finish(false);
+    } else if (leader_match_last - leader_match_first == 1 && leader_match_is_exact()) {
+        // Unique match with no longer continuation, no need to wait
+        leader_finish(true);
+    }
+}
+
+#        ifdef CONSOLE_ENABLE
+/* Report table entries that are out of order or repeated, which the search
+ * would silently never match.
+ */
+static void leader_sequences_check(void) {
+    for (uint8_t i = 1; i < LEADER_SEQUENCE_COUNT; i++) {
+        for (uint8_t position = 0; position < LEADER_SEQUENCE_LENGTH; position++) {
+            uint16_t previous = leader_sequence_key(i - 1, position);
+            uint16_t key      = leader_sequence_key(i, position);
+
+            if (previous < key) break;
+            if (previous > key || position == LEADER_SEQUENCE_LENGTH - 1 || key == 0) {
+                dprintf("leader: leader_sequences[%u] is not sorted after the one before it\n", i);
+                break;
+            }
+        }
+    }
+}
+#        endif
+
+void matrix_scan_leader(void) {
+    if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT) {
+        leader_finish(true);
+    }
+}
+#    endif
 
 void qk_leader_start(void) {
     if (leading) {
         return;
     }
+#    if defined(LEADER_SEQUENCE_COUNT) && defined(CONSOLE_ENABLE)
+    static bool leader_sequences_checked = false;
+    if (debug_enable && !leader_sequences_checked) {
+        leader_sequences_checked = true;
+        leader_sequences_check();
+    }
+#    endif
     leader_start();
     leading              = true;
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#    ifdef LEADER_SEQUENCE_COUNT
+    leader_match_first = 0;
+    leader_match_last  = LEADER_SEQUENCE_COUNT;
+#    endif
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
@@ -58,6 +165,9 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                 if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
                     leader_sequence[leader_sequence_size] = keycode;
                     leader_sequence_size++;
+#    ifdef LEADER_SEQUENCE_COUNT
+                    leader_match_key(keycode);
+#    endif
                 } else {
                     leading = false;
                     leader_end();
@@ -19,23 +19,49 @@
 
 #include "quantum.h"
 
+#ifndef LEADER_SEQUENCE_LENGTH
+#    define LEADER_SEQUENCE_LENGTH 5
+#endif
+
 bool process_leader(uint16_t keycode, keyrecord_t *record);
 
 void leader_start(void);
 void leader_end(void);
 void qk_leader_start(void);
 
-#define SEQ_ONE_KEY(key) if (leader_sequence[0] == (key) && leader_sequence[1] == 0 && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
-#define SEQ_TWO_KEYS(key1, key2) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
-#define SEQ_THREE_KEYS(key1, key2, key3) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == 0 && leader_sequence[4] == 0)
-#define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
-#define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
+#define SEQ_ONE_KEY(key) if (leader_sequence_size == 1 && leader_sequence[0] == (key))
+#define SEQ_TWO_KEYS(key1, key2) if (leader_sequence_size == 2 && leader_sequence[0] == (key1) && leader_sequence[1] == (key2))
+#define SEQ_THREE_KEYS(key1, key2, key3) if (leader_sequence_size == 3 && leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3))
+#define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence_size == 4 && leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4))
+#define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence_size == 5 && leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
-#define LEADER_EXTERNS()                \
-    extern bool     leading;            \
-    extern uint16_t leader_time;        \
-    extern uint16_t leader_sequence[5]; \
+#define LEADER_EXTERNS()                                     \
+    extern bool     leading;                                 \
+    extern uint16_t leader_time;                             \
+    extern uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH]; \
     extern uint8_t  leader_sequence_size
 #define LEADER_DICTIONARY() if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
 
+#ifdef LEADER_SEQUENCE_COUNT
+/* Declarative leader sequences.
+ *
+ * The table is searched as a trie: each key typed after the leader narrows
+ * the range of candidate sequences, so it must be sorted by keycode, one key
+ * position at a time (shorter sequences before their continuations). A
+ * sequence fires as soon as no longer sequence shares its prefix, and
+ * otherwise when LEADER_TIMEOUT expires.
+ */
+typedef struct {
+    uint16_t keys[LEADER_SEQUENCE_LENGTH];
+    void (*fn)(void);
+} leader_sequence_t;
+
+#    define LEADER_SEQ(func, ...) \
+        { .keys = {__VA_ARGS__}, .fn = func }
+
+extern const leader_sequence_t leader_sequences[LEADER_SEQUENCE_COUNT];
+
+void matrix_scan_leader(void);
+#endif
+
 #endif
@@ -24,8 +24,16 @@
 uint8_t get_oneshot_mods(void);
 #endif
 
+#ifndef TAP_DANCE_MAX_ACTIVE
+#    define TAP_DANCE_MAX_ACTIVE 8
+#endif
+
 static uint16_t last_td;
-static int8_t   highest_td = -1;
+
+// Indices of the dances currently in flight, oldest first. Only these are
+// looked at on interrupts and on every matrix scan.
+static uint8_t active_td[TAP_DANCE_MAX_ACTIVE];
+static uint8_t active_td_count = 0;
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
     qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -107,22 +115,51 @@ static inline void process_tap_dance_action_on_reset(qk_tap_dance_action_t *acti
     send_keyboard_report();
 }
 
+static bool activate_tap_dance(uint8_t idx) {
+    if (active_td_count >= TAP_DANCE_MAX_ACTIVE) return false;
+    active_td[active_td_count++] = idx;
+    return true;
+}
+
+static void deactivate_tap_dance(uint8_t idx) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_td[i] == idx) {
+            active_td_count--;
+            for (; i < active_td_count; i++) {
+                active_td[i] = active_td[i + 1];
+            }
+            return;
+        }
+    }
+}
+
+static inline uint16_t get_tap_dance_term(qk_tap_dance_action_t *action) { return action->custom_tapping_term > 0 ? action->custom_tapping_term : TAPPING_TERM; }
+
+/* Whether no further tap or hold can change the outcome of the dance. Dances
+ * with a hold action can only be decided once the last tap is released.
+ */
+static inline bool is_tap_dance_decided(qk_tap_dance_action_t *action) {
+    if (!action->max_taps || action->state.count < action->max_taps) return false;
+    return !action->hold_action || !action->state.pressed;
+}
+
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
     qk_tap_dance_action_t *action;
 
     if (!record->event.pressed) return;
 
-    if (highest_td == -1) return;
-
-    for (int i = 0; i <= highest_td; i++) {
-        action = &tap_dance_actions[i];
-        if (action->state.count) {
-            if (keycode == action->state.keycode && keycode == last_td) continue;
+    for (uint8_t i = 0; i < active_td_count;) {
+        uint8_t idx = active_td[i];
+        action      = &tap_dance_actions[idx];
+        if (!(keycode == action->state.keycode && keycode == last_td)) {
             action->state.interrupted          = true;
             action->state.interrupting_keycode = keycode;
             process_tap_dance_action_on_dance_finished(action);
             reset_tap_dance(&action->state);
         }
+        // Only advance if the dance is still in the list, otherwise the
+        // next one has been shifted into this slot.
+        if (i < active_td_count && active_td[i] == idx) i++;
     }
 }
 
@@ -132,11 +169,13 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
     switch (keycode) {
         case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
-            if ((int16_t)idx > highest_td) highest_td = idx;
             action = &tap_dance_actions[idx];
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
+                // If too many dances are in flight to time this one out,
+                // resolve it on its first tap instead.
+                bool untracked        = !action->state.count && !activate_tap_dance(idx);
                 action->state.keycode = keycode;
                 action->state.count++;
                 action->state.timer = timer_read();
@@ -150,7 +189,14 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
                 process_tap_dance_action_on_each_tap(action);
 
                 last_td = keycode;
+
+                if (untracked || is_tap_dance_decided(action)) {
+                    process_tap_dance_action_on_dance_finished(action);
+                }
             } else {
+                if (action->state.count && !action->state.finished && is_tap_dance_decided(action)) {
+                    process_tap_dance_action_on_dance_finished(action);
+                }
                 if (action->state.count && action->state.finished) {
                     reset_tap_dance(&action->state);
                 }
@@ -163,20 +209,14 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void matrix_scan_tap_dance() {
-    if (highest_td == -1) return;
-    uint16_t tap_user_defined;
-
-    for (uint8_t i = 0; i <= highest_td; i++) {
-        qk_tap_dance_action_t *action = &tap_dance_actions[i];
-        if (action->custom_tapping_term > 0) {
-            tap_user_defined = action->custom_tapping_term;
-        } else {
-            tap_user_defined = TAPPING_TERM;
-        }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
+    for (uint8_t i = 0; i < active_td_count;) {
+        uint8_t                idx    = active_td[i];
+        qk_tap_dance_action_t *action = &tap_dance_actions[idx];
+        if (timer_elapsed(action->state.timer) > get_tap_dance_term(action)) {
             process_tap_dance_action_on_dance_finished(action);
             reset_tap_dance(&action->state);
         }
+        if (i < active_td_count && active_td[i] == idx) i++;
     }
 }
 
@@ -188,6 +228,7 @@ void reset_tap_dance(qk_tap_dance_state_t *state) {
     action = &tap_dance_actions[state->keycode - QK_TAP_DANCE];
 
     process_tap_dance_action_on_reset(action);
+    deactivate_tap_dance(state->keycode - QK_TAP_DANCE);
 
     state->count                = 0;
     state->interrupted          = false;
@@ -45,6 +45,8 @@ typedef struct {
     } fn;
     qk_tap_dance_state_t state;
     uint16_t             custom_tapping_term;
+    uint8_t              max_taps;
+    bool                 hold_action;
     void *               user_data;
 } qk_tap_dance_action_t;
 
@@ -79,6 +81,12 @@ typedef struct {
 #    define ACTION_TAP_DANCE_FN_ADVANCED_TIME(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, tap_specific_tapping_term) \
         { .fn = {user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset}, .user_data = NULL, .custom_tapping_term = tap_specific_tapping_term, }
 
+#    define ACTION_TAP_DANCE_FN_ADVANCED_MAX(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, tap_max_taps) \
+        { .fn = {user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset}, .user_data = NULL, .max_taps = tap_max_taps, }
+
+#    define ACTION_TAP_DANCE_FN_ADVANCED_MAX_HOLD(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, tap_max_taps) \
+        { .fn = {user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset}, .user_data = NULL, .max_taps = tap_max_taps, .hold_action = true, }
+
 extern qk_tap_dance_action_t tap_dance_actions[];
 
 /* To be used internally */
@@ -49,6 +49,10 @@ extern backlight_config_t backlight_config;
 #    include "encoder.h"
 #endif
 
+#if defined(AUDIO_ENABLE) && defined(AUDIO_BENCHMARK)
+#    include "audio_benchmark.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -93,6 +97,8 @@ void register_code16(uint16_t code) {
     } else {
         do_code16(code, register_weak_mods);
     }
+    // Make sure the host sees the modifiers before the key
+    flush_keyboard_report();
     register_code(code);
 }
 
@@ -107,6 +113,7 @@ void unregister_code16(uint16_t code) {
 
 void tap_code16(uint16_t code) {
     register_code16(code);
+    flush_keyboard_report();
 #if TAP_CODE_DELAY > 0
     wait_ms(TAP_CODE_DELAY);
 #endif
@@ -171,97 +178,131 @@ uint16_t get_event_keycode(keyevent_t event) {
         return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
 }
 
-/* Main keycode processing function. Hands off handling to other functions,
- * then processes internal Quantum keycodes, then processes ACTIONs.
+/* Keycode processor pipeline, run in order by process_record_quantum().
+ *
+ * Each processor declares the keycode range it claims, and is skipped for any
+ * keycode outside of it. Processors that need to observe every event (to record
+ * them, to cancel pending state on other keys, or because they are modal) claim
+ * PROCESS_ALL_KEYCODES. A processor that handles several disjoint ranges is
+ * registered once per range, in adjacent entries, so ordering is unaffected.
  */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record);
+typedef bool (*process_record_func_t)(uint16_t keycode, keyrecord_t *record);
 
-    // This is how you use actions here
-    // if (keycode == KC_LEAD) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
+typedef struct {
+    process_record_func_t process;
+    uint16_t              min;
+    uint16_t              max;
+} process_record_handler_t;
 
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled() && record->event.pressed) {
-        velocikey_accelerate();
-    }
-#endif
-
-#ifdef TAP_DANCE_ENABLE
-    preprocess_tap_dance(keycode, record);
-#endif
+#define PROCESS_ALL_KEYCODES 0x0000, 0xFFFF
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+static const process_record_handler_t PROGMEM process_record_handlers[] = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    {process_dynamic_macro, PROCESS_ALL_KEYCODES},
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    {process_clicky, PROCESS_ALL_KEYCODES},
 #endif  // AUDIO_CLICKY
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    {process_haptic, PROCESS_ALL_KEYCODES},
 #endif  // HAPTIC_ENABLE
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+    {process_rgb_matrix, PROCESS_ALL_KEYCODES},
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    {process_record_via, FN_MO13, MACRO15},
 #endif
-            process_record_kb(keycode, record) &&
+    {process_record_kb, PROCESS_ALL_KEYCODES},
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    {process_midi, MIDI_TONE_MIN, MI_BENDU},
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    {process_audio, AU_ON, AU_TOG},
+    {process_audio, MUV_IN, MUV_DE},
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    {process_steno, QK_STENO, QK_STENO_MAX},
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    {process_music, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    {process_tap_dance, QK_TAP_DANCE, QK_TAP_DANCE_MAX},
 #endif
 #if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+    {process_unicode_common, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    {process_leader, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
+    {process_combo, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+    {process_printer, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    {process_auto_shift, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+    {process_terminal, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    {process_space_cadet, PROCESS_ALL_KEYCODES},
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+    {process_magic, MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_ALT_GUI},
+    {process_magic, MAGIC_SWAP_LCTL_LGUI, MAGIC_EE_HANDS_RIGHT},
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+    {process_rgb, RGB_TOG, RGB_MODE_RGBTEST},
 #endif
-            true)) {
+};
+
+#define PROCESS_RECORD_HANDLER_COUNT (sizeof(process_record_handlers) / sizeof(process_record_handlers[0]))
+
+/* Main keycode processing function. Hands off handling to other functions,
+ * then processes internal Quantum keycodes, then processes ACTIONs.
+ */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record);
+
+    // This is how you use actions here
+    // if (keycode == KC_LEAD) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#ifdef VELOCIKEY_ENABLE
+    if (velocikey_enabled() && record->event.pressed) {
+        velocikey_accelerate();
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    preprocess_tap_dance(keycode, record);
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
         return false;
     }
+#endif
+
+    for (uint8_t i = 0; i < PROCESS_RECORD_HANDLER_COUNT; i++) {
+        const process_record_handler_t *handler = &process_record_handlers[i];
+        if (keycode < pgm_read_word(&handler->min) || keycode > pgm_read_word(&handler->max)) {
+            continue;
+        }
+        process_record_func_t process = (process_record_func_t)pgm_read_ptr(&handler->process);
+        if (!process(keycode, record)) {
+            return false;
+        }
+    }
 
     if (record->event.pressed) {
         switch (keycode) {
@@ -495,6 +536,10 @@ void send_char(char ascii_code) {
     if (is_altgred) {
         register_code(KC_RALT);
     }
+    if (is_shifted || is_altgred) {
+        // Make sure the host sees the modifiers before the key
+        flush_keyboard_report();
+    }
     tap_code(keycode);
     if (is_altgred) {
         unregister_code(KC_RALT);
@@ -628,6 +673,14 @@ void matrix_scan_quantum() {
     matrix_scan_music();
 #endif
 
+#if defined(AUDIO_ENABLE) && defined(AUDIO_DRIVER_WAVETABLE)
+    audio_task();
+#endif
+
+#if defined(AUDIO_ENABLE) && defined(AUDIO_BENCHMARK)
+    audio_benchmark_task();
+#endif
+
 #ifdef TAP_DANCE_ENABLE
     matrix_scan_tap_dance();
 #endif
@@ -636,6 +689,10 @@ void matrix_scan_quantum() {
     matrix_scan_combo();
 #endif
 
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_COUNT)
+    matrix_scan_leader();
+#endif
+
 #ifdef LED_MATRIX_ENABLE
     led_matrix_task();
 #endif
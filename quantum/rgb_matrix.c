@@ -120,7 +120,9 @@ rgb_counters_t  g_rgb_counters;
 static uint32_t rgb_counters_buffer;
 
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
-uint8_t rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
+uint8_t      rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
+uint8_t      rgb_frame_buffer_active[(MATRIX_ROWS * MATRIX_COLS + 7) / 8];
+frame_cell_t rgb_frame_buffer_cell[DRIVER_LED_TOTAL];
 #endif
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -128,6 +130,11 @@ last_hit_t        g_last_hit_tracker;
 static last_hit_t last_hit_buffer;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+// Set by key events, rendering skips a task run so the next one is handled sooner
+static bool rgb_render_preempt = false;
+#endif
+
 void eeconfig_read_rgb_matrix(void) { eeprom_read_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
 
 void eeconfig_update_rgb_matrix(void) { eeprom_update_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
@@ -163,6 +170,65 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+#ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
+static void rgb_frame_buffer_map_leds(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        rgb_frame_buffer_cell[i] = NO_FRAME_CELL;
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t led[LED_HITS_TO_REMEMBER];
+            uint8_t led_count = rgb_matrix_map_row_column_to_led(row, col, led);
+            for (uint8_t j = 0; j < led_count; j++) {
+                if (rgb_frame_buffer_cell[led[j]] == NO_FRAME_CELL) {
+                    rgb_frame_buffer_cell[led[j]] = row * MATRIX_COLS + col;
+                }
+            }
+        }
+    }
+}
+
+void rgb_frame_buffer_set(uint8_t row, uint8_t col, uint8_t val) {
+    frame_cell_t cell          = row * MATRIX_COLS + col;
+    rgb_frame_buffer[row][col] = val;
+    // A cell set to zero is dropped by the next decay
+    if (val) {
+        rgb_frame_buffer_active[cell / 8] |= 1 << (cell % 8);
+    }
+}
+
+void rgb_frame_buffer_clear(void) {
+    memset(rgb_frame_buffer, 0, sizeof(rgb_frame_buffer));
+    memset(rgb_frame_buffer_active, 0, sizeof(rgb_frame_buffer_active));
+}
+
+bool rgb_frame_buffer_idle(void) {
+    for (uint16_t i = 0; i < sizeof(rgb_frame_buffer_active); i++) {
+        if (rgb_frame_buffer_active[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void rgb_frame_buffer_decay(uint8_t hold) {
+    uint8_t *cells = &rgb_frame_buffer[0][0];
+    for (uint16_t i = 0; i < sizeof(rgb_frame_buffer_active); i++) {
+        uint8_t bits = rgb_frame_buffer_active[i];
+        for (uint8_t bit = 0; bits; bit++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            frame_cell_t cell = i * 8 + bit;
+            if (cells[cell] != hold && cells[cell] > 0) {
+                cells[cell]--;
+            }
+            if (cells[cell] == 0) {
+                rgb_frame_buffer_active[i] &= ~(1 << bit);
+            }
+        }
+    }
+}
+#endif  // RGB_MATRIX_FRAMEBUFFER_EFFECTS
+
 void rgb_matrix_update_pwm_buffers(void) { rgb_matrix_driver.flush(); }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color(index, red, green, blue); }
@@ -170,6 +236,9 @@ void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color_all(red, green, blue); }
 
 bool process_rgb_matrix(uint16_t keycode, keyrecord_t *record) {
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_render_preempt = true;
+#endif
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     uint8_t led[LED_HITS_TO_REMEMBER];
     uint8_t led_count = 0;
@@ -254,6 +323,111 @@ static uint8_t         rgb_last_effect   = UINT8_MAX;
 static effect_params_t rgb_effect_params = {0, 0xFF};
 static rgb_task_states rgb_task_state    = SYNCING;
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+#    if RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+static uint8_t rgb_render_slice = RGB_MATRIX_LED_PROCESS_LIMIT;
+#    else
+static uint8_t rgb_render_slice = DRIVER_LED_TOTAL;
+#    endif
+// Frame start, and the start of the running effect call
+static uint16_t rgb_render_timer;
+static uint16_t rgb_render_start;
+
+// Measured over the last RGB_RENDER_GOVERNOR_PERIOD ms
+#    define RGB_RENDER_GOVERNOR_PERIOD 128
+static uint32_t rgb_govern_timer;
+static uint32_t rgb_govern_loops;
+static uint16_t rgb_govern_runs;
+static uint16_t rgb_govern_ticks;
+static bool     rgb_govern_slow_frame;
+
+static uint16_t rgb_rate_timer;
+static uint16_t rgb_rate_frames;
+static uint32_t rgb_rate_loops;
+static uint16_t rgb_fps;
+static uint32_t rgb_scan_rate;
+
+uint16_t rgb_matrix_get_fps(void) { return rgb_fps; }
+uint32_t rgb_matrix_get_scan_rate(void) { return rgb_scan_rate; }
+
+static void rgb_govern_reset(void) {
+    rgb_govern_timer      = timer_read32();
+    rgb_govern_loops      = 0;
+    rgb_govern_runs       = 0;
+    rgb_govern_ticks      = 0;
+    rgb_govern_slow_frame = false;
+}
+
+// Called once per frame, resizes the slice every RGB_RENDER_GOVERNOR_PERIOD.
+// An effect call is usually shorter than a timer tick, but the ticks that
+// fall inside calls add up to the time spent rendering over many of them.
+// The slice only shrinks when a rendering task run is slower than
+// RGB_MATRIX_TARGET_SCAN_RATE allows and rendering is a good part of it, so
+// a board that scans slowly for other reasons keeps its frame rate. It
+// grows while frames take longer than RGB_MATRIX_LED_FLUSH_LIMIT and there
+// is headroom, and never drops below what RGB_MATRIX_MIN_FPS needs.
+static void rgb_render_governor(void) {
+    if (timer_elapsed(rgb_render_timer) > RGB_MATRIX_LED_FLUSH_LIMIT) {
+        rgb_govern_slow_frame = true;
+    }
+
+    uint32_t elapsed = timer_elapsed32(rgb_govern_timer);
+    if (elapsed < RGB_RENDER_GOVERNOR_PERIOD || !rgb_govern_runs) {
+        return;
+    }
+    // Rendering stopped for a while, start measuring again
+    if (elapsed > RGB_RENDER_GOVERNOR_PERIOD * 8) {
+        rgb_govern_reset();
+        return;
+    }
+
+    // In microseconds: a task run without rendering, and an effect call
+    uint32_t base   = (elapsed > rgb_govern_ticks ? elapsed - rgb_govern_ticks : 0) * 1000 / rgb_govern_loops;
+    uint32_t cost   = (uint32_t)rgb_govern_ticks * 1000 / rgb_govern_runs;
+    uint32_t target = 1000000UL / RGB_MATRIX_TARGET_SCAN_RATE;
+    uint32_t slice  = rgb_render_slice;
+
+    if (base + cost > target && cost * 4 > base + cost) {
+        slice = target > base ? slice * (target - base) / cost : 0;
+        if (slice < rgb_render_slice / 2) {
+            slice = rgb_render_slice / 2;
+        }
+    } else if (rgb_govern_slow_frame && base + cost < target - target / 8) {
+        slice += slice / 4 ? slice / 4 : 1;
+        if (cost && slice > rgb_render_slice * (target - base) / cost) {
+            slice = rgb_render_slice * (target - base) / cost;
+        }
+    }
+
+    // Enough LEDs per run to finish a frame at RGB_MATRIX_MIN_FPS
+    uint32_t frame_runs = 1000000UL / RGB_MATRIX_MIN_FPS / (base + cost ? base + cost : 1);
+    uint32_t min_slice  = frame_runs ? (DRIVER_LED_TOTAL + frame_runs - 1) / frame_runs : DRIVER_LED_TOTAL;
+    if (slice < min_slice) {
+        slice = min_slice;
+    }
+    if (slice < 1) {
+        slice = 1;
+    }
+    if (slice > DRIVER_LED_TOTAL) {
+        slice = DRIVER_LED_TOTAL;
+    }
+    rgb_render_slice = slice;
+    rgb_govern_reset();
+}
+
+static void rgb_render_rate_task(void) {
+    rgb_rate_loops++;
+    if (timer_elapsed(rgb_rate_timer) >= 1000) {
+        rgb_fps         = rgb_rate_frames;
+        rgb_scan_rate   = rgb_rate_loops;
+        rgb_rate_frames = 0;
+        rgb_rate_loops  = 0;
+        rgb_rate_timer  = timer_read();
+        dprintf("rgb matrix: %u fps, %lu scans/s, %u LEDs per run\n", rgb_fps, rgb_scan_rate, rgb_render_slice);
+    }
+}
+#endif
+
 static void rgb_task_timers(void) {
     // Update double buffer timers
     uint16_t deltaTime  = timer_elapsed32(rgb_counters_buffer);
@@ -287,6 +461,10 @@ static void rgb_task_sync(void) {
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_effect_params.led_max = 0;
+    rgb_render_timer          = timer_read();
+#endif
 
     // update double buffers
     g_rgb_counters.tick = rgb_counters_buffer;
@@ -301,6 +479,10 @@ static void rgb_task_start(void) {
 static void rgb_task_render(uint8_t effect) {
     bool rendering         = false;
     rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_effect_params.led_min = rgb_effect_params.led_max;
+    rgb_effect_params.led_max = rgb_effect_params.led_min < UINT8_MAX - rgb_render_slice ? rgb_effect_params.led_min + rgb_render_slice : UINT8_MAX;
+#endif
 
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
@@ -362,12 +544,24 @@ static void rgb_task_flush(uint8_t effect) {
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_render_governor();
+    rgb_rate_frames++;
+#endif
+
     // next task
     rgb_task_state = SYNCING;
 }
 
 void rgb_matrix_task(void) {
     rgb_task_timers();
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_govern_loops++;
+    rgb_render_rate_task();
+#endif
+#ifdef RGB_MATRIX_HOST_STREAMING
+    host_stream_task();
+#endif
 
     // Ideally we would also stop sending zeros to the LED driver PWM buffers
     // while suspended and just do a software shutdown. This is a cheap hack for now.
@@ -379,7 +573,19 @@ void rgb_matrix_task(void) {
             rgb_task_start();
             break;
         case RENDERING:
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+            // Let the key events in flight be handled first
+            if (rgb_render_preempt) {
+                rgb_render_preempt = false;
+                break;
+            }
+            rgb_render_start = timer_read();
             rgb_task_render(effect);
+            rgb_govern_ticks += timer_elapsed(rgb_render_start);
+            rgb_govern_runs++;
+#else
+            rgb_task_render(effect);
+#endif
             break;
         case FLUSHING:
             rgb_task_flush(effect);
@@ -420,6 +626,10 @@ void rgb_matrix_init(void) {
     }
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
+    rgb_frame_buffer_map_leds();
+#endif
+
     if (!eeconfig_is_enabled()) {
         dprintf("rgb_matrix_init_drivers eeconfig is not enabled.\n");
         eeconfig_init();
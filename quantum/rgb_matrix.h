@@ -44,7 +44,20 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#ifndef RGB_MATRIX_TARGET_SCAN_RATE
+#    define RGB_MATRIX_TARGET_SCAN_RATE 1000
+#endif
+
+#ifndef RGB_MATRIX_MIN_FPS
+#    define RGB_MATRIX_MIN_FPS 20
+#endif
+
+#if defined(RGB_MATRIX_ADAPTIVE_RENDER)
+#    define RGB_MATRIX_USE_LIMITS(min, max) \
+        uint8_t min = params->led_min;      \
+        uint8_t max = params->led_max;      \
+        if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
 #    define RGB_MATRIX_USE_LIMITS(min, max)                        \
         uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
         uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
@@ -83,6 +96,7 @@ enum rgb_matrix_effects {
     RGB_MATRIX_EFFECT_MAX
 };
 
+void eeconfig_read_rgb_matrix(void);
 void eeconfig_update_rgb_matrix_default(void);
 
 uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
@@ -95,6 +109,33 @@ bool process_rgb_matrix(uint16_t keycode, keyrecord_t *record);
 
 void rgb_matrix_task(void);
 
+#ifdef RGB_MATRIX_HOST_STREAMING
+// Frames streamed from the host over raw HID, see the HOST_STREAM effect.
+// data starts at the operation: op, frame sequence number (2), then
+// for rgb_matrix_stream_data: first LED, LED count, then r, g, b per LED.
+// Commit and stop get a status in data[3]. Returns true if data should be
+// sent back to the host as the reply.
+enum rgb_matrix_stream_op {
+    rgb_matrix_stream_data   = 0x00,
+    rgb_matrix_stream_commit = 0x01,
+    rgb_matrix_stream_stop   = 0x02,
+};
+
+enum rgb_matrix_stream_status {
+    rgb_matrix_stream_ok             = 0x00,
+    rgb_matrix_stream_error_sequence = 0x01,
+    rgb_matrix_stream_error_unknown  = 0x02,
+};
+
+bool rgb_matrix_stream_receive(uint8_t *data, uint8_t length);
+#endif
+
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+// Frames flushed and rgb_matrix_task calls over the last second
+uint16_t rgb_matrix_get_fps(void);
+uint32_t rgb_matrix_get_scan_rate(void);
+#endif
+
 // This runs after another backlight effect and replaces
 // colors already set
 void rgb_matrix_indicators(void);
@@ -173,6 +214,16 @@ extern last_hit_t g_last_hit_tracker;
 #endif
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
+// One bit per cell of rgb_frame_buffer that may be non zero
+extern uint8_t rgb_frame_buffer_active[(MATRIX_ROWS * MATRIX_COLS + 7) / 8];
+// The cell each LED shows, worked out once at init
+extern frame_cell_t rgb_frame_buffer_cell[DRIVER_LED_TOTAL];
+
+void rgb_frame_buffer_set(uint8_t row, uint8_t col, uint8_t val);
+void rgb_frame_buffer_clear(void);
+bool rgb_frame_buffer_idle(void);
+// Counts every active cell down by one, except those at hold
+void rgb_frame_buffer_decay(uint8_t hold);
 #endif
 
 #endif
@@ -18,34 +18,38 @@ bool DIGITAL_RAIN(effect_params_t* params) {
 
     if (params->init) {
         rgb_matrix_set_color_all(0, 0, 0);
-        memset(rgb_frame_buffer, 0, sizeof(rgb_frame_buffer));
+        rgb_frame_buffer_clear();
         drop = 0;
     }
 
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-            if (row == 0 && drop == 0 && rand() < RAND_MAX / RGB_DIGITAL_RAIN_DROPS) {
+    // neither fully bright nor dark, decay it
+    rgb_frame_buffer_decay(max_intensity);
+
+    if (drop == 0) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (rand() < RAND_MAX / RGB_DIGITAL_RAIN_DROPS) {
                 // top row, pixels have just fallen and we're
                 // making a new rain drop in this column
-                rgb_frame_buffer[row][col] = max_intensity;
-            } else if (rgb_frame_buffer[row][col] > 0 && rgb_frame_buffer[row][col] < max_intensity) {
-                // neither fully bright nor dark, decay it
-                rgb_frame_buffer[row][col]--;
+                rgb_frame_buffer_set(0, col, max_intensity);
             }
-            // set the pixel colour
-            uint8_t led[LED_HITS_TO_REMEMBER];
-            uint8_t led_count = rgb_matrix_map_row_column_to_led(row, col, led);
+        }
+    }
 
-            // TODO: multiple leds are supported mapped to the same row/column
-            if (led_count > 0) {
-                if (rgb_frame_buffer[row][col] > pure_green_intensity) {
-                    const uint8_t boost = (uint8_t)((uint16_t)max_brightness_boost * (rgb_frame_buffer[row][col] - pure_green_intensity) / (max_intensity - pure_green_intensity));
-                    rgb_matrix_set_color(led[0], boost, max_intensity, boost);
-                } else {
-                    const uint8_t green = (uint8_t)((uint16_t)max_intensity * rgb_frame_buffer[row][col] / pure_green_intensity);
-                    rgb_matrix_set_color(led[0], 0, green, 0);
-                }
-            }
+    // set the pixel colours
+    uint8_t* cells = &rgb_frame_buffer[0][0];
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        frame_cell_t cell = rgb_frame_buffer_cell[i];
+        if (cell == NO_FRAME_CELL) continue;
+
+        uint8_t val = cells[cell];
+        if (val > pure_green_intensity) {
+            const uint8_t boost = (uint8_t)((uint16_t)max_brightness_boost * (val - pure_green_intensity) / (max_intensity - pure_green_intensity));
+            rgb_matrix_set_color(i, boost, max_intensity, boost);
+        } else if (val > 0) {
+            const uint8_t green = (uint8_t)((uint16_t)max_intensity * val / pure_green_intensity);
+            rgb_matrix_set_color(i, 0, green, 0);
+        } else {
+            rgb_matrix_set_color(i, 0, 0, 0);
         }
     }
 
@@ -63,7 +67,7 @@ bool DIGITAL_RAIN(effect_params_t* params) {
                     // allow old bright pixel to decay
                     rgb_frame_buffer[row - 1][col]--;
                     // make this pixel bright
-                    rgb_frame_buffer[row][col] = max_intensity;
+                    rgb_frame_buffer_set(row, col, max_intensity);
                 }
             }
         }
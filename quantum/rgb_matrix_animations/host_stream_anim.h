@@ -0,0 +1,126 @@
+#ifdef RGB_MATRIX_HOST_STREAMING
+RGB_MATRIX_EFFECT(HOST_STREAM)
+#    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+#        ifndef RGB_MATRIX_HOST_STREAM_TIMEOUT
+#            define RGB_MATRIX_HOST_STREAM_TIMEOUT 2000
+#        endif
+
+// The host fills the back buffer, which is swapped to the front at the
+// start of the next frame once committed. Partial frames keep the rest of
+// the previous frame, so the back buffer starts as a copy of the front.
+static RGB      host_stream_buffer[2][DRIVER_LED_TOTAL];
+static uint8_t  host_stream_back     = 1;
+static uint16_t host_stream_sequence = 0;
+static bool     host_stream_pending  = false;
+static bool     host_stream_active   = false;
+static uint32_t host_stream_timer    = 0;
+
+static void host_stream_swap(void) {
+    host_stream_back ^= 1;
+    memcpy(host_stream_buffer[host_stream_back], host_stream_buffer[host_stream_back ^ 1], sizeof(host_stream_buffer[0]));
+    host_stream_pending = false;
+}
+
+static void host_stream_stop(void) {
+    host_stream_active  = false;
+    host_stream_pending = false;
+    // Back to the saved effect
+    eeconfig_read_rgb_matrix();
+}
+
+// Forget the stream if the mode was changed while it was running, so the
+// next data packet switches back to it
+static void host_stream_check_mode(void) {
+    if (rgb_matrix_get_mode() != RGB_MATRIX_HOST_STREAM) {
+        host_stream_active  = false;
+        host_stream_pending = false;
+    }
+}
+
+// Called from rgb_matrix_task, as the effect does not run while it is
+// disabled or another mode is showing
+static void host_stream_task(void) {
+    if (!host_stream_active) {
+        return;
+    }
+    host_stream_check_mode();
+    if (host_stream_active && timer_elapsed32(host_stream_timer) > RGB_MATRIX_HOST_STREAM_TIMEOUT) {
+        host_stream_stop();
+    }
+}
+
+bool rgb_matrix_stream_receive(uint8_t *data, uint8_t length) {
+    uint8_t *op       = &(data[0]);
+    uint16_t sequence = (data[1] << 8) | data[2];
+
+    host_stream_check_mode();
+    host_stream_timer = timer_read32();
+    switch (*op) {
+        case rgb_matrix_stream_data: {
+            if (length < 5) {
+                return false;
+            }
+            uint8_t first = data[3];
+            uint8_t count = data[4];
+            if (!host_stream_active) {
+                host_stream_active = true;
+                rgb_matrix_enable_noeeprom();
+                rgb_matrix_mode_noeeprom(RGB_MATRIX_HOST_STREAM);
+            }
+            if (sequence != host_stream_sequence) {
+                // The host has moved on before the last frame was shown
+                if (host_stream_pending) {
+                    host_stream_swap();
+                }
+                host_stream_sequence = sequence;
+            }
+            if (count > (length - 5) / 3) {
+                count = (length - 5) / 3;
+            }
+            for (uint8_t i = 0; i < count && first + i < DRIVER_LED_TOTAL; i++) {
+                host_stream_buffer[host_stream_back][first + i] = (RGB){.r = data[5 + i * 3], .g = data[6 + i * 3], .b = data[7 + i * 3]};
+            }
+            // Data packets are not acknowledged
+            return false;
+        }
+        case rgb_matrix_stream_commit: {
+            if (host_stream_active && sequence == host_stream_sequence) {
+                host_stream_pending = true;
+                data[3]             = rgb_matrix_stream_ok;
+            } else {
+                data[3] = rgb_matrix_stream_error_sequence;
+            }
+            return true;
+        }
+        case rgb_matrix_stream_stop: {
+            if (host_stream_active) {
+                host_stream_stop();
+            }
+            data[3] = rgb_matrix_stream_ok;
+            return true;
+        }
+        default: {
+            data[3] = rgb_matrix_stream_error_unknown;
+            return true;
+        }
+    }
+}
+
+bool HOST_STREAM(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    if (led_min == 0 && host_stream_pending) {
+        host_stream_swap();
+    }
+
+    RGB* front = host_stream_buffer[host_stream_back ^ 1];
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_set_color(i, front[i].r, front[i].g, front[i].b);
+    }
+    return led_max < DRIVER_LED_TOTAL;
+}
+
+#    endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif      // RGB_MATRIX_HOST_STREAMING
@@ -2,6 +2,8 @@
 RGB_MATRIX_EFFECT(TYPING_HEATMAP)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
+static void typing_heatmap_add(uint8_t row, uint8_t col, uint8_t amount) { rgb_frame_buffer_set(row, col, qadd8(rgb_frame_buffer[row][col], amount)); }
+
 void process_rgb_matrix_typing_heatmap(keyrecord_t* record) {
     uint8_t row   = record->event.key.row;
     uint8_t col   = record->event.key.col;
@@ -10,55 +12,56 @@ void process_rgb_matrix_typing_heatmap(keyrecord_t* record) {
     uint8_t m_col = col - 1;
     uint8_t p_col = col + 1;
 
-    if (m_col < col) rgb_frame_buffer[row][m_col] = qadd8(rgb_frame_buffer[row][m_col], 16);
-    rgb_frame_buffer[row][col] = qadd8(rgb_frame_buffer[row][col], 32);
-    if (p_col < MATRIX_COLS) rgb_frame_buffer[row][p_col] = qadd8(rgb_frame_buffer[row][p_col], 16);
+    if (m_col < col) typing_heatmap_add(row, m_col, 16);
+    typing_heatmap_add(row, col, 32);
+    if (p_col < MATRIX_COLS) typing_heatmap_add(row, p_col, 16);
 
     if (p_row < MATRIX_ROWS) {
-        if (m_col < col) rgb_frame_buffer[p_row][m_col] = qadd8(rgb_frame_buffer[p_row][m_col], 13);
-        rgb_frame_buffer[p_row][col] = qadd8(rgb_frame_buffer[p_row][col], 16);
-        if (p_col < MATRIX_COLS) rgb_frame_buffer[p_row][p_col] = qadd8(rgb_frame_buffer[p_row][p_col], 13);
+        if (m_col < col) typing_heatmap_add(p_row, m_col, 13);
+        typing_heatmap_add(p_row, col, 16);
+        if (p_col < MATRIX_COLS) typing_heatmap_add(p_row, p_col, 13);
     }
 
     if (m_row < row) {
-        if (m_col < col) rgb_frame_buffer[m_row][m_col] = qadd8(rgb_frame_buffer[m_row][m_col], 13);
-        rgb_frame_buffer[m_row][col] = qadd8(rgb_frame_buffer[m_row][col], 16);
-        if (p_col < MATRIX_COLS) rgb_frame_buffer[m_row][p_col] = qadd8(rgb_frame_buffer[m_row][p_col], 13);
+        if (m_col < col) typing_heatmap_add(m_row, m_col, 13);
+        typing_heatmap_add(m_row, col, 16);
+        if (p_col < MATRIX_COLS) typing_heatmap_add(m_row, p_col, 13);
     }
 }
 
 bool TYPING_HEATMAP(effect_params_t* params) {
-    // Modified version of RGB_MATRIX_USE_LIMITS to work off of matrix row / col size
-    uint8_t led_min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;
-    uint8_t led_max = led_min + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (led_max > sizeof(rgb_frame_buffer)) led_max = sizeof(rgb_frame_buffer);
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
     if (params->init) {
         rgb_matrix_set_color_all(0, 0, 0);
-        memset(rgb_frame_buffer, 0, sizeof rgb_frame_buffer);
+        rgb_frame_buffer_clear();
     }
 
-    // Render heatmap & decrease
-    for (int i = led_min; i < led_max; i++) {
-        uint8_t row = i % MATRIX_ROWS;
-        uint8_t col = i / MATRIX_ROWS;
-        uint8_t val = rgb_frame_buffer[row][col];
-
-        // set the pixel colour
-        uint8_t led[LED_HITS_TO_REMEMBER];
-        uint8_t led_count = rgb_matrix_map_row_column_to_led(row, col, led);
-        for (uint8_t j = 0; j < led_count; ++j) {
-            if (!HAS_ANY_FLAGS(g_led_config.flags[led[j]], params->flags)) continue;
+    // Once the keys have cooled down there is nothing left to work out
+    bool     idle  = rgb_frame_buffer_idle();
+    uint8_t* cells = &rgb_frame_buffer[0][0];
+    for (uint8_t i = led_min; i < led_max; i++) {
+        frame_cell_t cell = rgb_frame_buffer_cell[i];
+        if (cell == NO_FRAME_CELL) continue;
+        RGB_MATRIX_TEST_LED_FLAGS();
 
-            HSV hsv = {170 - qsub8(val, 85), rgb_matrix_config.hsv.s, scale8((qadd8(170, val) - 170) * 3, rgb_matrix_config.hsv.v)};
-            RGB rgb = hsv_to_rgb(hsv);
-            rgb_matrix_set_color(led[j], rgb.r, rgb.g, rgb.b);
+        uint8_t val = idle ? 0 : cells[cell];
+        if (val == 0) {
+            rgb_matrix_set_color(i, 0, 0, 0);
+            continue;
         }
 
-        rgb_frame_buffer[row][col] = qsub8(val, 1);
+        HSV hsv = {170 - qsub8(val, 85), rgb_matrix_config.hsv.s, scale8((qadd8(170, val) - 170) * 3, rgb_matrix_config.hsv.v)};
+        RGB rgb = hsv_to_rgb(hsv);
+        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+    }
+
+    // Decrease once the whole frame is drawn
+    if (!idle && led_max == DRIVER_LED_TOTAL) {
+        rgb_frame_buffer_decay(0);
     }
 
-    return led_max < sizeof(rgb_frame_buffer);
+    return led_max < DRIVER_LED_TOTAL;
 }
 
 #    endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -4,20 +4,49 @@
 
 typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+// Sets the range of distances a hit can still light at this tick.
+// Returns false once the hit can't light anything.
+typedef bool (*reactive_splash_reach_f)(uint16_t tick, uint8_t* min_dist, uint8_t* max_dist);
+
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, reactive_splash_reach_f reach_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t count = g_last_hit_tracker.count;
+    // Work out once per frame which hits are live, and how far their wave reaches
+    uint8_t  count = 0;
+    uint8_t  hit[LED_HITS_TO_REMEMBER];
+    uint16_t hit_tick[LED_HITS_TO_REMEMBER];
+    uint8_t  hit_min[LED_HITS_TO_REMEMBER];
+    uint8_t  hit_max[LED_HITS_TO_REMEMBER];
+    for (uint8_t j = start; j < g_last_hit_tracker.count; j++) {
+        hit[count]      = j;
+        hit_tick[count] = scale16by8(g_last_hit_tracker.tick[j], rgb_matrix_config.speed);
+        hit_min[count]  = 0;
+        hit_max[count]  = 255;
+        if (reach_func && !reach_func(hit_tick[count], &hit_min[count], &hit_max[count])) {
+            continue;
+        }
+        count++;
+    }
+
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
         HSV hsv = rgb_matrix_config.hsv;
         hsv.v   = 0;
-        for (uint8_t j = start; j < count; j++) {
-            int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
-            int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
-            uint8_t  dist = sqrt16(dx * dx + dy * dy);
-            uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], rgb_matrix_config.speed);
-            hsv           = effect_func(hsv, dx, dy, dist, tick);
+        for (uint8_t k = 0; k < count; k++) {
+            uint8_t j  = hit[k];
+            int16_t dx = g_led_config.point[i].x - g_last_hit_tracker.x[j];
+            int16_t dy = g_led_config.point[i].y - g_last_hit_tracker.y[j];
+            if (reach_func) {
+                // The distance lies between max(|dx|, |dy|) and |dx| + |dy|,
+                // so most LEDs are ruled out before taking the square root
+                uint8_t adx = dx < 0 ? -dx : dx;
+                uint8_t ady = dy < 0 ? -dy : dy;
+                if (adx > hit_max[k] || ady > hit_max[k] || adx + ady < hit_min[k]) {
+                    continue;
+                }
+            }
+            uint8_t dist = sqrt16(dx * dx + dy * dy);
+            hsv          = effect_func(hsv, dx, dy, dist, hit_tick[k]);
         }
         hsv.v   = scale8(hsv.v, rgb_matrix_config.hsv.v);
         RGB rgb = hsv_to_rgb(hsv);
@@ -26,4 +55,6 @@ bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, react
     return led_max < DRIVER_LED_TOTAL;
 }
 
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) { return effect_runner_reactive_splash_reach(start, params, effect_func, NULL); }
+
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -41,6 +41,11 @@ typedef struct PACKED {
     uint8_t     iter;
     led_flags_t flags;
     bool        init;
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    // LEDs to render in this iteration, set by the render governor
+    uint8_t led_min;
+    uint8_t led_max;
+#endif
 } effect_params_t;
 
 typedef struct PACKED {
@@ -66,6 +71,17 @@ typedef struct PACKED {
 
 #define NO_LED 255
 
+#ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
+// Index of a matrix cell in rgb_frame_buffer, counted row by row
+#    if MATRIX_ROWS * MATRIX_COLS < UINT8_MAX
+typedef uint8_t frame_cell_t;
+#    else
+typedef uint16_t frame_cell_t;
+#    endif
+
+#    define NO_FRAME_CELL ((frame_cell_t)-1)
+#endif
+
 typedef struct PACKED {
     uint8_t matrix_co[MATRIX_ROWS][MATRIX_COLS];
     point_t point[DRIVER_LED_TOTAL];
@@ -103,9 +103,13 @@ static uint8_t effect_start_pos   = 0;
 static uint8_t effect_end_pos     = RGBLED_NUM;
 static uint8_t effect_num_leds    = RGBLED_NUM;
 
+// Set once led_frame holds what the LEDs are showing
+static bool led_frame_valid = false;
+
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds) {
     clipping_start_pos = start_pos;
     clipping_num_leds  = num_leds;
+    led_frame_valid    = false;
 }
 
 void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
@@ -567,7 +571,7 @@ void rgblight_sethsv_at(uint8_t hue, uint8_t sat, uint8_t val, uint8_t index) {
     rgblight_setrgb_at(tmp_led.r, tmp_led.g, tmp_led.b, index);
 }
 
-#if defined(RGBLIGHT_EFFECT_BREATHING) || defined(RGBLIGHT_EFFECT_RAINBOW_MOOD) || defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL) || defined(RGBLIGHT_EFFECT_SNAKE) || defined(RGBLIGHT_EFFECT_KNIGHT)
+#ifdef RGBLIGHT_USE_TIMER
 
 static uint8_t get_interval_time(const uint8_t *default_interval_address, uint8_t velocikey_min, uint8_t velocikey_max) {
     return
@@ -617,9 +621,11 @@ void rgblight_sethsv_slave(uint8_t hue, uint8_t sat, uint8_t val) { rgblight_set
 #endif  // ifndef RGBLIGHT_SPLIT
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
+// The last frame sent to the LEDs, after mapping and RGBW conversion
+static LED_TYPE led_frame[RGBLED_NUM];
+
 void rgblight_set(void) {
-    LED_TYPE *start_led;
-    uint16_t  num_leds = clipping_num_leds;
+    uint16_t num_leds = clipping_num_leds;
 
     if (!rgblight_config.enable) {
         for (uint8_t i = effect_start_pos; i < effect_end_pos; i++) {
@@ -632,22 +638,28 @@ void rgblight_set(void) {
         }
     }
 
+    // The LEDs keep their colour, so a frame that matches the last one isn't sent again
+    bool changed = !led_frame_valid;
+    for (uint8_t i = clipping_start_pos; i < clipping_start_pos + num_leds; i++) {
 #    ifdef RGBLIGHT_LED_MAP
-    LED_TYPE led0[RGBLED_NUM];
-    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
-        led0[i] = led[pgm_read_byte(&led_map[i])];
-    }
-    start_led = led0 + clipping_start_pos;
+        LED_TYPE next = led[pgm_read_byte(&led_map[i])];
 #    else
-    start_led = led + clipping_start_pos;
+        LED_TYPE next = led[i];
 #    endif
-
 #    ifdef RGBW
-    for (uint8_t i = 0; i < num_leds; i++) {
-        convert_rgb_to_rgbw(&start_led[i]);
-    }
+        convert_rgb_to_rgbw(&next);
 #    endif
-    ws2812_setleds(start_led, num_leds);
+        if (memcmp(&next, &led_frame[i], sizeof(next)) != 0) {
+            led_frame[i] = next;
+            changed      = true;
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    led_frame_valid = true;
+    ws2812_setleds(led_frame + clipping_start_pos, num_leds);
 }
 #endif
 
@@ -758,71 +770,73 @@ static void rgblight_effect_dummy(animation_status_t *anim) {
     **/
 }
 
-void rgblight_task(void) {
-    if (rgblight_status.timer_enabled) {
-        effect_func_t effect_func   = rgblight_effect_dummy;
-        uint16_t      interval_time = 2000;  // dummy interval
-        uint8_t       delta         = rgblight_config.mode - rgblight_status.base_mode;
-        animation_status.delta      = delta;
+// Animated effects by base mode. Effects with a table of intervals pick
+// one by the mode's offset from its base mode, shifted right by step_shift.
+typedef struct {
+    effect_func_t   func;
+    const uint8_t * intervals;
+    const uint16_t *fixed_interval;
+    uint8_t         step_shift;
+    uint8_t         velocikey_min;
+    uint8_t         velocikey_max;
+} rgblight_effect_t;
 
-        // static light mode, do nothing here
-        if (1 == 0) {  // dummy
-        }
+#    ifdef RGBLIGHT_EFFECT_CHRISTMAS
+static const uint16_t RGBLED_CHRISTMAS_INTERVALS[] PROGMEM = {RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL};
+#    endif
+#    ifdef RGBLIGHT_EFFECT_ALTERNATING
+static const uint16_t RGBLED_ALTERNATING_INTERVALS[] PROGMEM = {500};
+#    endif
+
+static const rgblight_effect_t rgblight_effects[RGBLIGHT_MODE_last] PROGMEM = {
 #    ifdef RGBLIGHT_EFFECT_BREATHING
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_BREATHING) {
-            // breathing mode
-            interval_time = get_interval_time(&RGBLED_BREATHING_INTERVALS[delta], 1, 100);
-            effect_func   = rgblight_effect_breathing;
-        }
+    [RGBLIGHT_MODE_BREATHING] = {rgblight_effect_breathing, RGBLED_BREATHING_INTERVALS, NULL, 0, 1, 100},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_RAINBOW_MOOD
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_RAINBOW_MOOD) {
-            // rainbow mood mode
-            interval_time = get_interval_time(&RGBLED_RAINBOW_MOOD_INTERVALS[delta], 5, 100);
-            effect_func   = rgblight_effect_rainbow_mood;
-        }
+    [RGBLIGHT_MODE_RAINBOW_MOOD] = {rgblight_effect_rainbow_mood, RGBLED_RAINBOW_MOOD_INTERVALS, NULL, 0, 5, 100},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_RAINBOW_SWIRL
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_RAINBOW_SWIRL) {
-            // rainbow swirl mode
-            interval_time = get_interval_time(&RGBLED_RAINBOW_SWIRL_INTERVALS[delta / 2], 1, 100);
-            effect_func   = rgblight_effect_rainbow_swirl;
-        }
+    // Swirl, snake and knight modes alternate direction, two modes per speed
+    [RGBLIGHT_MODE_RAINBOW_SWIRL] = {rgblight_effect_rainbow_swirl, RGBLED_RAINBOW_SWIRL_INTERVALS, NULL, 1, 1, 100},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_SNAKE
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_SNAKE) {
-            // snake mode
-            interval_time = get_interval_time(&RGBLED_SNAKE_INTERVALS[delta / 2], 1, 200);
-            effect_func   = rgblight_effect_snake;
-        }
+    [RGBLIGHT_MODE_SNAKE] = {rgblight_effect_snake, RGBLED_SNAKE_INTERVALS, NULL, 1, 1, 200},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_KNIGHT
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_KNIGHT) {
-            // knight mode
-            interval_time = get_interval_time(&RGBLED_KNIGHT_INTERVALS[delta], 5, 100);
-            effect_func   = rgblight_effect_knight;
-        }
+    [RGBLIGHT_MODE_KNIGHT] = {rgblight_effect_knight, RGBLED_KNIGHT_INTERVALS, NULL, 0, 5, 100},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_CHRISTMAS
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_CHRISTMAS) {
-            // christmas mode
-            interval_time = RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL;
-            effect_func   = (effect_func_t)rgblight_effect_christmas;
-        }
+    [RGBLIGHT_MODE_CHRISTMAS] = {rgblight_effect_christmas, NULL, RGBLED_CHRISTMAS_INTERVALS},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_RGB_TEST
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_RGB_TEST) {
-            // RGB test mode
-            interval_time = pgm_read_word(&RGBLED_RGBTEST_INTERVALS[0]);
-            effect_func   = (effect_func_t)rgblight_effect_rgbtest;
-        }
+    [RGBLIGHT_MODE_RGB_TEST] = {rgblight_effect_rgbtest, NULL, RGBLED_RGBTEST_INTERVALS},
 #    endif
 #    ifdef RGBLIGHT_EFFECT_ALTERNATING
-        else if (rgblight_status.base_mode == RGBLIGHT_MODE_ALTERNATING) {
-            interval_time = 500;
-            effect_func   = (effect_func_t)rgblight_effect_alternating;
-        }
+    [RGBLIGHT_MODE_ALTERNATING] = {rgblight_effect_alternating, NULL, RGBLED_ALTERNATING_INTERVALS},
 #    endif
+};
+
+void rgblight_task(void) {
+    if (rgblight_status.timer_enabled) {
+        effect_func_t effect_func   = rgblight_effect_dummy;
+        uint16_t      interval_time = 2000;  // dummy interval
+        uint8_t       delta         = rgblight_config.mode - rgblight_status.base_mode;
+        animation_status.delta      = delta;
+
+        // static light modes have no entry, do nothing here
+        if (rgblight_status.base_mode < RGBLIGHT_MODE_last) {
+            const rgblight_effect_t *effect = &rgblight_effects[rgblight_status.base_mode];
+            effect_func_t            func   = (effect_func_t)pgm_read_ptr(&effect->func);
+            if (func) {
+                const uint8_t *intervals = (const uint8_t *)pgm_read_ptr(&effect->intervals);
+                if (intervals) {
+                    interval_time = get_interval_time(&intervals[delta >> pgm_read_byte(&effect->step_shift)], pgm_read_byte(&effect->velocikey_min), pgm_read_byte(&effect->velocikey_max));
+                } else {
+                    interval_time = pgm_read_word((const uint16_t *)pgm_read_ptr(&effect->fixed_interval));
+                }
+                effect_func = func;
+            }
+        }
         if (animation_status.restart) {
             animation_status.restart    = false;
             animation_status.last_timer = timer_read() - interval_time - 1;
@@ -47,6 +47,12 @@
 #include "tmk_core/common/eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
 
+#include <string.h>
+
+#ifndef MIN
+#    define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
 void via_qmk_backlight_set_value(uint8_t *data);
@@ -214,6 +220,514 @@ bool process_record_via(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+#ifndef VIA_BULK_TRANSFER_WINDOW
+#    define VIA_BULK_TRANSFER_WINDOW 8
+#endif
+
+// Committed writes are sent to EEPROM this many bytes at a time
+#ifndef VIA_BULK_TRANSFER_BLOCK_SIZE
+#    define VIA_BULK_TRANSFER_BLOCK_SIZE 32
+#endif
+
+// Writes are held in RAM until they are committed. Larger writes need an
+// EEPROM scratch region (VIA_BULK_TRANSFER_SCRATCH_ADDR and _SIZE), or must
+// be split by the host.
+#ifndef VIA_BULK_TRANSFER_BUFFER_SIZE
+#    if defined(__AVR__)
+#        define VIA_BULK_TRANSFER_BUFFER_SIZE 128
+#    else
+#        define VIA_BULK_TRANSFER_BUFFER_SIZE 1024
+#    endif
+#endif
+
+#ifndef VIA_BULK_TRANSFER_SCRATCH_SIZE
+#    define VIA_BULK_TRANSFER_SCRATCH_SIZE 0
+#elif !defined(VIA_BULK_TRANSFER_SCRATCH_ADDR)
+#    error "VIA_BULK_TRANSFER_SCRATCH_SIZE needs VIA_BULK_TRANSFER_SCRATCH_ADDR"
+#endif
+
+#if VIA_BULK_TRANSFER_SCRATCH_SIZE > VIA_BULK_TRANSFER_BUFFER_SIZE
+#    define VIA_BULK_TRANSFER_MAX_WRITE VIA_BULK_TRANSFER_SCRATCH_SIZE
+#else
+#    define VIA_BULK_TRANSFER_MAX_WRITE VIA_BULK_TRANSFER_BUFFER_SIZE
+#endif
+
+// 32 byte report, less the command ID and the sequence number
+#define VIA_BULK_TRANSFER_PAYLOAD_SIZE 29
+
+typedef struct {
+    bool     active;
+    uint8_t  direction;
+    uint8_t  region;
+    uint16_t offset;
+    uint16_t length;
+    uint16_t crc;
+    // Write state
+    uint16_t received;
+    uint16_t next_sequence;
+    uint16_t running_crc;
+} via_bulk_transfer_t;
+
+static via_bulk_transfer_t bulk_transfer;
+static uint8_t             bulk_buffer[VIA_BULK_TRANSFER_BUFFER_SIZE];
+
+// CRC-16/CCITT-FALSE, seed with 0xFFFF
+static uint16_t via_crc16_update(uint16_t crc, const uint8_t *data, uint16_t size) {
+    while (size--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t via_bulk_region_size(uint8_t region) {
+    switch (region) {
+        case id_bulk_region_keymap:
+            return dynamic_keymap_get_layer_count() * MATRIX_ROWS * MATRIX_COLS * 2;
+        case id_bulk_region_macros:
+            return dynamic_keymap_macro_get_buffer_size();
+        default:
+            return 0;
+    }
+}
+
+static void via_bulk_region_read(uint16_t offset, uint16_t size, uint8_t *data) {
+    if (bulk_transfer.region == id_bulk_region_keymap) {
+        dynamic_keymap_get_buffer(offset, size, data);
+    } else {
+        dynamic_keymap_macro_get_buffer(offset, size, data);
+    }
+}
+
+// Holds received data until the commit, in RAM or else in the scratch region
+static void via_bulk_stage(uint16_t done, const uint8_t *data, uint8_t size) {
+    if (bulk_transfer.length <= VIA_BULK_TRANSFER_BUFFER_SIZE) {
+        memcpy(&bulk_buffer[done], data, size);
+    }
+#if VIA_BULK_TRANSFER_SCRATCH_SIZE > 0
+    else {
+        eeprom_update_block(data, (void *)VIA_BULK_TRANSFER_SCRATCH_ADDR + done, size);
+    }
+#endif
+}
+
+// Writes the staged data to the region, a block at a time
+static void via_bulk_write(void) {
+    for (uint16_t done = 0; done < bulk_transfer.length; done += VIA_BULK_TRANSFER_BLOCK_SIZE) {
+        uint16_t size = MIN(VIA_BULK_TRANSFER_BLOCK_SIZE, bulk_transfer.length - done);
+        uint8_t *data;
+#if VIA_BULK_TRANSFER_SCRATCH_SIZE > 0
+        uint8_t block[VIA_BULK_TRANSFER_BLOCK_SIZE];
+        if (bulk_transfer.length > VIA_BULK_TRANSFER_BUFFER_SIZE) {
+            eeprom_read_block(block, (void *)VIA_BULK_TRANSFER_SCRATCH_ADDR + done, size);
+            data = block;
+        } else
+#endif
+        {
+            data = &bulk_buffer[done];
+        }
+        if (bulk_transfer.region == id_bulk_region_keymap) {
+            dynamic_keymap_set_buffer(bulk_transfer.offset + done, size, data);
+        } else {
+            dynamic_keymap_macro_set_buffer(bulk_transfer.offset + done, size, data);
+        }
+    }
+}
+
+static void via_bulk_transfer_begin(uint8_t *command_data) {
+    uint8_t  direction = command_data[0];
+    uint8_t  region    = command_data[1];
+    uint16_t offset    = (command_data[2] << 8) | command_data[3];
+    uint16_t length    = (command_data[4] << 8) | command_data[5];
+    uint16_t crc       = (command_data[6] << 8) | command_data[7];
+
+    bulk_transfer.active = false;
+    if (direction > id_bulk_transfer_read_back || length == 0 || offset >= via_bulk_region_size(region) || length > via_bulk_region_size(region) - offset) {
+        command_data[0] = id_bulk_status_error_range;
+        return;
+    }
+    if (direction == id_bulk_transfer_write && length > VIA_BULK_TRANSFER_MAX_WRITE) {
+        // Tell the host how much it can write at once
+        command_data[0] = id_bulk_status_error_range;
+        command_data[3] = VIA_BULK_TRANSFER_MAX_WRITE >> 8;
+        command_data[4] = VIA_BULK_TRANSFER_MAX_WRITE & 0xFF;
+        return;
+    }
+
+    bulk_transfer = (via_bulk_transfer_t){
+        .active      = true,
+        .direction   = direction,
+        .region      = region,
+        .offset      = offset,
+        .length      = length,
+        .crc         = crc,
+        .running_crc = 0xFFFF,
+    };
+
+    if (direction == id_bulk_transfer_read_back) {
+        // Let the host check what it is about to download
+        uint8_t chunk[VIA_BULK_TRANSFER_PAYLOAD_SIZE];
+        crc = 0xFFFF;
+        for (uint16_t done = 0; done < length; done += sizeof(chunk)) {
+            uint16_t size = MIN((uint16_t)sizeof(chunk), length - done);
+            via_bulk_region_read(offset + done, size, chunk);
+            crc = via_crc16_update(crc, chunk, size);
+        }
+        command_data[3] = crc >> 8;
+        command_data[4] = crc & 0xFF;
+    }
+
+    command_data[0] = id_bulk_status_ok;
+    command_data[1] = VIA_BULK_TRANSFER_WINDOW;
+    command_data[2] = VIA_BULK_TRANSFER_PAYLOAD_SIZE;
+}
+
+// Returns true if the packet needs a reply
+static bool via_bulk_transfer_data(uint8_t *command_data) {
+    uint16_t sequence = (command_data[0] << 8) | command_data[1];
+    uint8_t  status   = id_bulk_status_ok;
+
+    if (!bulk_transfer.active || bulk_transfer.direction != id_bulk_transfer_write || bulk_transfer.received >= bulk_transfer.length) {
+        status = id_bulk_status_error_state;
+    } else if (sequence != bulk_transfer.next_sequence) {
+        // Go back N: the host resends from the expected packet
+        status = id_bulk_status_error_sequence;
+    } else {
+        uint8_t *payload = &command_data[2];
+        uint8_t  size    = MIN(VIA_BULK_TRANSFER_PAYLOAD_SIZE, bulk_transfer.length - bulk_transfer.received);
+
+        bulk_transfer.running_crc = via_crc16_update(bulk_transfer.running_crc, payload, size);
+        via_bulk_stage(bulk_transfer.received, payload, size);
+        bulk_transfer.received += size;
+        bulk_transfer.next_sequence++;
+
+        if (bulk_transfer.next_sequence % VIA_BULK_TRANSFER_WINDOW != 0 && bulk_transfer.received < bulk_transfer.length) {
+            return false;
+        }
+    }
+
+    command_data[0] = status;
+    command_data[1] = bulk_transfer.next_sequence >> 8;
+    command_data[2] = bulk_transfer.next_sequence & 0xFF;
+    return true;
+}
+
+static void via_bulk_transfer_read(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t sequence     = (command_data[0] << 8) | command_data[1];
+    uint8_t  count        = command_data[2];
+    uint16_t packets      = (bulk_transfer.length + VIA_BULK_TRANSFER_PAYLOAD_SIZE - 1) / VIA_BULK_TRANSFER_PAYLOAD_SIZE;
+
+    if (!bulk_transfer.active || bulk_transfer.direction != id_bulk_transfer_read_back || count == 0 || count > VIA_BULK_TRANSFER_WINDOW || sequence >= packets) {
+        command_data[0] = 0xFF;
+        command_data[1] = 0xFF;
+        command_data[2] = bulk_transfer.active ? id_bulk_status_error_range : id_bulk_status_error_state;
+        raw_hid_send(data, length);
+        return;
+    }
+
+    for (; count && sequence < packets; count--, sequence++) {
+        uint16_t done = sequence * VIA_BULK_TRANSFER_PAYLOAD_SIZE;
+        uint8_t  size = MIN(VIA_BULK_TRANSFER_PAYLOAD_SIZE, bulk_transfer.length - done);
+
+        memset(&command_data[2], 0, VIA_BULK_TRANSFER_PAYLOAD_SIZE);
+        command_data[0] = sequence >> 8;
+        command_data[1] = sequence & 0xFF;
+        via_bulk_region_read(bulk_transfer.offset + done, size, &command_data[2]);
+        raw_hid_send(data, length);
+    }
+}
+
+static void via_bulk_transfer_commit(uint8_t *command_data) {
+    if (!bulk_transfer.active || bulk_transfer.direction != id_bulk_transfer_write || bulk_transfer.received != bulk_transfer.length) {
+        command_data[0] = id_bulk_status_error_state;
+    } else if (bulk_transfer.running_crc != bulk_transfer.crc) {
+        // Nothing has been written, so the region is as it was
+        command_data[0] = id_bulk_status_error_crc;
+    } else {
+        via_bulk_write();
+        command_data[0] = id_bulk_status_ok;
+    }
+    bulk_transfer.active = false;
+}
+
+// Largest batch of keycode writes that fits in a packet
+#define VIA_BATCH_MAX_KEYCODE_WRITES ((32 - 2) / 6)
+
+typedef struct {
+    uint16_t offset;
+    uint16_t keycode;
+} via_batch_keycode_write_t;
+
+static uint8_t via_batch_operation_size(uint8_t operation) {
+    switch (operation) {
+        case id_dynamic_keymap_get_keycode:
+        case id_dynamic_keymap_set_keycode:
+            return 6;
+        case id_lighting_get_value:
+        case id_lighting_set_value:
+            return 4;
+        case id_get_keyboard_value:
+            return 6;
+        case id_lighting_save:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void via_batch_commit(via_batch_keycode_write_t *writes, uint8_t write_count) {
+    // Sort by offset so that neighbouring keys become one EEPROM write.
+    // Insertion sort is stable, so a later write to the same key wins.
+    for (uint8_t i = 1; i < write_count; i++) {
+        via_batch_keycode_write_t write = writes[i];
+        uint8_t                   j     = i;
+        for (; j > 0 && writes[j - 1].offset > write.offset; j--) {
+            writes[j] = writes[j - 1];
+        }
+        writes[j] = write;
+    }
+
+    uint8_t  run[VIA_BATCH_MAX_KEYCODE_WRITES * 2];
+    uint8_t  run_size   = 0;
+    uint16_t run_offset = 0;
+    for (uint8_t i = 0; i < write_count; i++) {
+        if (run_size && writes[i].offset == run_offset + run_size - 2) {
+            // Same key again, overwrite it
+            run_size -= 2;
+        } else if (run_size && writes[i].offset != run_offset + run_size) {
+            dynamic_keymap_set_buffer(run_offset, run_size, run);
+            run_size = 0;
+        }
+        if (!run_size) {
+            run_offset = writes[i].offset;
+        }
+        // Big endian, as stored in EEPROM
+        run[run_size++] = writes[i].keycode >> 8;
+        run[run_size++] = writes[i].keycode & 0xFF;
+    }
+    if (run_size) {
+        dynamic_keymap_set_buffer(run_offset, run_size, run);
+    }
+}
+
+static void via_batch(uint8_t *command_data, uint8_t length) {
+    via_batch_keycode_write_t writes[VIA_BATCH_MAX_KEYCODE_WRITES];
+    uint8_t                   write_count   = 0;
+    bool                      save_lighting = false;
+    uint8_t                   count         = command_data[0];
+    uint8_t                   processed     = 0;
+    uint8_t                   i             = 1;
+
+    // command_data starts after the command ID
+    for (; processed < count; processed++) {
+        uint8_t *operation = &command_data[i];
+        uint8_t *op_data   = &command_data[i + 1];
+        uint8_t  size      = via_batch_operation_size(*operation);
+        if (size == 0 || i + size > length - 1) {
+            if (i < length - 1) {
+                *operation = id_batch_status_unhandled;
+            }
+            break;
+        }
+        i += size;
+
+        uint8_t status = id_batch_status_ok;
+        switch (*operation) {
+            case id_dynamic_keymap_get_keycode:
+            case id_dynamic_keymap_set_keycode: {
+                if (op_data[0] >= dynamic_keymap_get_layer_count() || op_data[1] >= MATRIX_ROWS || op_data[2] >= MATRIX_COLS) {
+                    status = id_batch_status_error_range;
+                    break;
+                }
+                uint16_t offset = ((op_data[0] * MATRIX_ROWS + op_data[1]) * MATRIX_COLS + op_data[2]) * 2;
+                if (*operation == id_dynamic_keymap_set_keycode) {
+                    writes[write_count++] = (via_batch_keycode_write_t){.offset = offset, .keycode = (op_data[3] << 8) | op_data[4]};
+                } else {
+                    uint16_t keycode = dynamic_keymap_get_keycode(op_data[0], op_data[1], op_data[2]);
+                    // Reads see writes earlier in the same batch
+                    for (uint8_t w = 0; w < write_count; w++) {
+                        if (writes[w].offset == offset) {
+                            keycode = writes[w].keycode;
+                        }
+                    }
+                    op_data[3] = keycode >> 8;
+                    op_data[4] = keycode & 0xFF;
+                }
+                break;
+            }
+            case id_lighting_set_value: {
+#if defined(VIA_QMK_BACKLIGHT_ENABLE)
+                via_qmk_backlight_set_value(op_data);
+#endif
+#if defined(VIA_QMK_RGBLIGHT_ENABLE)
+                via_qmk_rgblight_set_value(op_data);
+#endif
+#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE)
+                // Custom lighting needs the whole packet, use id_lighting_set_value for it
+                status = id_batch_status_unhandled;
+#endif
+                break;
+            }
+            case id_lighting_get_value: {
+#if defined(VIA_QMK_BACKLIGHT_ENABLE)
+                via_qmk_backlight_get_value(op_data);
+#endif
+#if defined(VIA_QMK_RGBLIGHT_ENABLE)
+                via_qmk_rgblight_get_value(op_data);
+#endif
+#if !defined(VIA_QMK_BACKLIGHT_ENABLE) && !defined(VIA_QMK_RGBLIGHT_ENABLE)
+                status = id_batch_status_unhandled;
+#endif
+                break;
+            }
+            case id_lighting_save: {
+#if defined(VIA_QMK_BACKLIGHT_ENABLE) || defined(VIA_QMK_RGBLIGHT_ENABLE)
+                save_lighting = true;
+#else
+                status = id_batch_status_unhandled;
+#endif
+                break;
+            }
+            case id_get_keyboard_value: {
+                uint32_t value;
+                if (op_data[0] == id_uptime) {
+                    value = timer_read32();
+                } else if (op_data[0] == id_layout_options) {
+                    value = via_get_layout_options();
+                } else {
+                    // Matrix state and keyboard level values don't fit here
+                    status = id_batch_status_unhandled;
+                    break;
+                }
+                op_data[1] = (value >> 24) & 0xFF;
+                op_data[2] = (value >> 16) & 0xFF;
+                op_data[3] = (value >> 8) & 0xFF;
+                op_data[4] = value & 0xFF;
+                break;
+            }
+        }
+        *operation = status;
+    }
+
+    via_batch_commit(writes, write_count);
+    if (save_lighting) {
+#if defined(VIA_QMK_BACKLIGHT_ENABLE)
+        eeconfig_update_backlight_current();
+#endif
+#if defined(VIA_QMK_RGBLIGHT_ENABLE)
+        eeconfig_update_rgblight_current();
+#endif
+    }
+    command_data[0] = processed;
+}
+
+#ifndef VIA_SWITCH_MATRIX_SNAPSHOT_INTERVAL
+#    define VIA_SWITCH_MATRIX_SNAPSHOT_INTERVAL 1000
+#endif
+
+// Stop streaming if the host goes away without unsubscribing
+#ifndef VIA_SWITCH_MATRIX_STREAM_TIMEOUT
+#    define VIA_SWITCH_MATRIX_STREAM_TIMEOUT 10000
+#endif
+
+#define VIA_SWITCH_MATRIX_EVENT_SIZE 4
+#define VIA_SWITCH_MATRIX_EVENTS_PER_PACKET ((32 - 2) / VIA_SWITCH_MATRIX_EVENT_SIZE)
+#define VIA_SWITCH_MATRIX_ROW_SIZE ((MATRIX_COLS + 7) / 8)
+
+static struct {
+    bool     enabled;
+    bool     snapshot_due;
+    uint16_t snapshot_interval;
+    uint16_t snapshot_timer;
+    uint32_t subscribe_timer;
+    uint8_t  event_count;
+    uint8_t  events[32];
+} matrix_stream;
+
+static void via_switch_matrix_subscribe(uint8_t *command_data) {
+    uint16_t interval = (command_data[1] << 8) | command_data[2];
+
+    matrix_stream.enabled           = command_data[0];
+    matrix_stream.snapshot_due      = matrix_stream.enabled;
+    matrix_stream.snapshot_interval = interval ? interval : VIA_SWITCH_MATRIX_SNAPSHOT_INTERVAL;
+    matrix_stream.subscribe_timer   = timer_read32();
+    matrix_stream.event_count       = 0;
+}
+
+static void via_switch_matrix_flush_events(void) {
+    if (matrix_stream.event_count) {
+        matrix_stream.events[0] = id_switch_matrix_event;
+        matrix_stream.events[1] = matrix_stream.event_count;
+        raw_hid_send(matrix_stream.events, sizeof(matrix_stream.events));
+        matrix_stream.event_count = 0;
+    }
+}
+
+static void via_switch_matrix_send_snapshot(void) {
+    uint8_t  packet[32];
+    uint8_t  rows_per_packet = (sizeof(packet) - 6) / VIA_SWITCH_MATRIX_ROW_SIZE;
+    uint16_t now             = timer_read();
+
+    for (uint8_t first = 0; first < MATRIX_ROWS; first += rows_per_packet) {
+        uint8_t count = MIN(rows_per_packet, MATRIX_ROWS - first);
+        uint8_t i     = 0;
+
+        memset(packet, 0, sizeof(packet));
+        packet[i++] = id_switch_matrix_snapshot;
+        packet[i++] = now >> 8;
+        packet[i++] = now & 0xFF;
+        packet[i++] = first;
+        packet[i++] = count;
+        packet[i++] = VIA_SWITCH_MATRIX_ROW_SIZE;
+        for (uint8_t row = first; row < first + count; row++) {
+            matrix_row_t value = matrix_get_row(row);
+            // Most significant byte first
+            for (int8_t byte = VIA_SWITCH_MATRIX_ROW_SIZE - 1; byte >= 0; byte--) {
+                packet[i++] = (value >> (byte * 8)) & 0xFF;
+            }
+        }
+        raw_hid_send(packet, sizeof(packet));
+    }
+    matrix_stream.snapshot_timer = now;
+}
+
+void via_switch_matrix_event(keyevent_t event) {
+    if (!matrix_stream.enabled) {
+        return;
+    }
+
+    uint8_t *e = &matrix_stream.events[2 + matrix_stream.event_count * VIA_SWITCH_MATRIX_EVENT_SIZE];
+    e[0]       = event.key.row;
+    e[1]       = event.key.col | (event.pressed ? 0x80 : 0);
+    e[2]       = event.time >> 8;
+    e[3]       = event.time & 0xFF;
+    if (++matrix_stream.event_count == VIA_SWITCH_MATRIX_EVENTS_PER_PACKET) {
+        via_switch_matrix_flush_events();
+    }
+}
+
+void via_task(void) {
+    if (!matrix_stream.enabled) {
+        return;
+    }
+
+    if (timer_elapsed32(matrix_stream.subscribe_timer) > VIA_SWITCH_MATRIX_STREAM_TIMEOUT) {
+        matrix_stream.enabled = false;
+        return;
+    }
+
+    // Everything from this scan goes out in one packet
+    via_switch_matrix_flush_events();
+
+    if (matrix_stream.snapshot_due || timer_elapsed(matrix_stream.snapshot_timer) >= matrix_stream.snapshot_interval) {
+        matrix_stream.snapshot_due = false;
+        via_switch_matrix_send_snapshot();
+    }
+}
+
 // Keyboard level code can override this to handle custom messages from VIA.
 // See raw_hid_receive() implementation.
 // DO NOT call raw_hid_send() in the overide function.
@@ -400,6 +914,42 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+        case id_bulk_transfer_begin: {
+            via_bulk_transfer_begin(command_data);
+            break;
+        }
+        case id_bulk_transfer_data: {
+            if (!via_bulk_transfer_data(command_data)) {
+                // Acknowledged at the end of the window
+                return;
+            }
+            break;
+        }
+        case id_bulk_transfer_read: {
+            // Replies with a window of packets
+            via_bulk_transfer_read(data, length);
+            return;
+        }
+        case id_bulk_transfer_commit: {
+            via_bulk_transfer_commit(command_data);
+            break;
+        }
+        case id_switch_matrix_subscribe: {
+            via_switch_matrix_subscribe(command_data);
+            break;
+        }
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_HOST_STREAMING)
+        case id_rgb_matrix_stream: {
+            if (!rgb_matrix_stream_receive(command_data, length - 1)) {
+                return;
+            }
+            break;
+        }
+#endif
+        case id_batch: {
+            via_batch(command_data, length);
+            break;
+        }
         case id_eeprom_reset: {
             via_eeprom_reset();
             break;
@@ -70,9 +70,84 @@ enum via_command_id {
     id_dynamic_keymap_get_layer_count       = 0x11,
     id_dynamic_keymap_get_buffer            = 0x12,
     id_dynamic_keymap_set_buffer            = 0x13,
+    id_bulk_transfer_begin                  = 0x14,
+    id_bulk_transfer_data                   = 0x15,
+    id_bulk_transfer_read                   = 0x16,
+    id_bulk_transfer_commit                 = 0x17,
+    id_batch                                = 0x18,
+    id_switch_matrix_subscribe              = 0x19,
+    id_switch_matrix_event                  = 0x1A,
+    id_switch_matrix_snapshot               = 0x1B,
+    id_rgb_matrix_stream                    = 0x1C,
     id_unhandled                            = 0xFF,
 };
 
+// Windowed bulk transfer of a whole EEPROM region.
+//
+// id_bulk_transfer_begin: direction, region, offset (2), length (2), CRC16 (2, writes only)
+//   reply: status, window size, payload bytes per packet, CRC16 of the region range (2, reads only)
+//   A write longer than the device can hold until the commit fails with
+//   id_bulk_status_error_range, and the reply holds the longest write (2)
+//   instead of the CRC16. The host can split it into several transfers.
+// id_bulk_transfer_data: sequence number (2), payload
+//   Sent by the host for writes. Only the last packet of each window, the last
+//   packet of the transfer or an out of sequence packet get a reply:
+//   status, next expected sequence number (2)
+// id_bulk_transfer_read: first sequence number (2), packet count (up to the window size)
+//   The device replies with that many packets: sequence number (2), payload.
+//   On error, a single packet with sequence number 0xFFFF and the status.
+// id_bulk_transfer_commit: (no data)
+//   Checks the CRC16 of everything received, and only if it matches writes it
+//   to EEPROM. On id_bulk_status_error_crc the region is left unchanged.
+//   reply: status
+enum via_bulk_transfer_direction {
+    id_bulk_transfer_write     = 0x00,
+    id_bulk_transfer_read_back = 0x01,
+};
+
+enum via_bulk_transfer_region {
+    id_bulk_region_keymap = 0x00,
+    id_bulk_region_macros = 0x01,
+};
+
+enum via_bulk_transfer_status {
+    id_bulk_status_ok             = 0x00,
+    id_bulk_status_error_state    = 0x01,
+    id_bulk_status_error_range    = 0x02,
+    id_bulk_status_error_sequence = 0x03,
+    id_bulk_status_error_crc      = 0x04,
+};
+
+// Several operations in one packet.
+//
+// id_batch: operation count, then the operations back to back. Each operation
+// is a command ID followed by the same data that command takes:
+//   id_dynamic_keymap_get_keycode / id_dynamic_keymap_set_keycode: layer, row, column, keycode (2)
+//   id_lighting_get_value / id_lighting_set_value: value ID, value (2)
+//   id_get_keyboard_value: value ID, value (4)
+//   id_lighting_save: (no data)
+// The reply has the same layout, with each command ID replaced by its status
+// and any values filled in. Processing stops at the first unknown command ID,
+// since the size of the rest can't be known; the first reply byte is the
+// number of operations processed. Keycode writes and lighting saves are held
+// back and applied to EEPROM together once the whole packet has been read.
+enum via_batch_status {
+    id_batch_status_ok          = 0x00,
+    id_batch_status_unhandled   = 0x01,
+    id_batch_status_error_range = 0x02,
+};
+
+// Switch matrix state stream, for live key testers.
+//
+// id_switch_matrix_subscribe: enable (1), snapshot interval in ms (2, 0 for the default)
+//   The subscription lapses after VIA_SWITCH_MATRIX_STREAM_TIMEOUT ms unless renewed.
+//   A snapshot is sent right after subscribing.
+// id_switch_matrix_event (device to host): event count, then per event
+//   row, column | 0x80 if pressed, scan timestamp in ms (2)
+// id_switch_matrix_snapshot (device to host): timestamp in ms (2), first row,
+//   row count, bytes per row, then the rows as in id_switch_matrix_state.
+//   Large matrices are split over several packets.
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01,  //
     id_layout_options      = 0x02,
@@ -156,5 +231,9 @@ void via_init(void);
 uint32_t via_get_layout_options(void);
 void     via_set_layout_options(uint32_t value);
 
+// Called by QMK core for each debounced matrix change, and once per scan.
+void via_switch_matrix_event(keyevent_t event);
+void via_task(void);
+
 // Called by QMK core to process VIA-specific keycodes.
 bool process_record_via(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,182 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <vector>
+
+extern "C" {
+#include "encoder.h"
+volatile bool isLeftHand = true;
+}
+
+struct Moved {
+    int8_t   index;
+    int8_t   delta;
+    uint16_t velocity;
+};
+
+struct Update {
+    int8_t index;
+    bool   clockwise;
+};
+
+static std::vector<Moved>  moved;
+static std::vector<Update> updates;
+static bool                moved_result = true;
+
+extern "C" bool encoder_moved_user(int8_t index, int8_t delta, uint16_t velocity) {
+    moved.push_back({index, delta, velocity});
+    return moved_result;
+}
+
+extern "C" void encoder_update_user(int8_t index, bool clockwise) { updates.push_back({index, clockwise}); }
+
+class Encoder : public TestFixture {
+   protected:
+    void SetUp() override {
+        moved.clear();
+        updates.clear();
+        moved_result = true;
+        // Long enough since the last move for the velocity to be just the detents
+        idle_for(1000);
+    }
+
+    // Steps an encoder through whole detents from its pin change interrupt,
+    // positive is clockwise. Every detent ends back on both pins low.
+    void turn(uint8_t index, int detents) {
+        static const uint8_t clockwise[]         = {2, 3, 1, 0};
+        static const uint8_t counter_clockwise[] = {1, 3, 2, 0};
+        const uint8_t*       states              = detents > 0 ? clockwise : counter_clockwise;
+        for (int i = 0; i < abs(detents); i++) {
+            for (uint8_t j = 0; j < 4; j++) {
+                gpio_fake_pins[index * 2]     = states[j] & 1;
+                gpio_fake_pins[index * 2 + 1] = states[j] & 2;
+                encoder_interrupt(index);
+            }
+        }
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(Encoder, DetentsMovedInOneScanAreReportedOnce) {
+    turn(0, 3);
+    EXPECT_TRUE(moved.empty());
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].index, 0);
+    EXPECT_EQ(moved[0].delta, 3);
+    EXPECT_EQ(moved[0].velocity, 3);
+
+    // Each detent is still passed to encoder_update_kb
+    ASSERT_EQ(updates.size(), 3u);
+    for (auto& update : updates) {
+        EXPECT_EQ(update.index, 0);
+        EXPECT_TRUE(update.clockwise);
+    }
+
+    run_one_scan_loop();
+    EXPECT_EQ(moved.size(), 1u);
+}
+
+TEST_F(Encoder, CounterClockwiseDetentsAreNegative) {
+    turn(1, -2);
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].index, 1);
+    EXPECT_EQ(moved[0].delta, -2);
+    ASSERT_EQ(updates.size(), 2u);
+    EXPECT_FALSE(updates[0].clockwise);
+    EXPECT_FALSE(updates[1].clockwise);
+}
+
+TEST_F(Encoder, ReturningFalseSkipsTheUpdates) {
+    moved_result = false;
+    turn(0, 4);
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].delta, 4);
+    EXPECT_TRUE(updates.empty());
+}
+
+TEST_F(Encoder, PartialDetentsAreNotReported) {
+    gpio_fake_pins[0] = false;
+    gpio_fake_pins[1] = true;
+    encoder_interrupt(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(moved.empty());
+    // Back where it started
+    gpio_fake_pins[1] = false;
+    encoder_interrupt(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(moved.empty());
+}
+
+TEST_F(Encoder, VelocityFollowsTheTimeSinceTheLastMove) {
+    turn(0, 1);
+    run_one_scan_loop();
+    idle_for(99);
+    turn(0, 2);
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 2u);
+    // 2 detents 100 ms after the last one
+    EXPECT_EQ(moved[1].velocity, 20);
+
+    turn(0, 1);
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 3u);
+    // 1 detent 1 ms later
+    EXPECT_EQ(moved[2].velocity, 1000);
+}
+
+TEST_F(Encoder, CountsKeepWorkingWhenTheyWrap) {
+    // The detent count is a byte, and wraps well within this
+    for (uint8_t i = 0; i < 3; i++) {
+        turn(1, 100);
+        run_one_scan_loop();
+    }
+    turn(1, -120);
+    run_one_scan_loop();
+    ASSERT_EQ(moved.size(), 4u);
+    EXPECT_EQ(moved[0].delta, 100);
+    EXPECT_EQ(moved[1].delta, 100);
+    EXPECT_EQ(moved[2].delta, 100);
+    EXPECT_EQ(moved[3].delta, -120);
+    EXPECT_EQ(updates.size(), 420u);
+}
+
+TEST_F(Encoder, SlaveDetentsArriveAsOneMove) {
+    // The right half encoders come after the left ones, and start at 0
+    uint8_t slave_state[2] = {5, 0};
+    encoder_update_raw(slave_state);
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].index, 2);
+    EXPECT_EQ(moved[0].delta, 5);
+    EXPECT_EQ(updates.size(), 5u);
+
+    // Backwards across the wrap of the byte the slave sends
+    slave_state[0] -= 20;
+    slave_state[1] += 1;
+    encoder_update_raw(slave_state);
+    ASSERT_EQ(moved.size(), 3u);
+    EXPECT_EQ(moved[1].index, 2);
+    EXPECT_EQ(moved[1].delta, -20);
+    EXPECT_EQ(moved[2].index, 3);
+    EXPECT_EQ(moved[2].delta, 1);
+
+    encoder_update_raw(slave_state);
+    EXPECT_EQ(moved.size(), 3u);
+}
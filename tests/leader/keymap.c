@@ -0,0 +1,34 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_LEAD, KC_A, KC_S, KC_D, KC_F}},
+};
+
+// Defined by the tests
+void leader_as(void);
+void leader_d(void);
+void leader_dd(void);
+void leader_ddd(void);
+
+const leader_sequence_t leader_sequences[LEADER_SEQUENCE_COUNT] PROGMEM = {
+    LEADER_SEQ(leader_as, KC_A, KC_S),
+    LEADER_SEQ(leader_d, KC_D),
+    LEADER_SEQ(leader_dd, KC_D, KC_D),
+    LEADER_SEQ(leader_ddd, KC_D, KC_D, KC_D),
+};
@@ -0,0 +1,133 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+#include <vector>
+
+using testing::_;
+using testing::AnyNumber;
+
+static std::vector<std::string> fired;
+static int                      ended;
+
+extern "C" {
+void leader_as(void) { fired.push_back("as"); }
+void leader_d(void) { fired.push_back("d"); }
+void leader_dd(void) { fired.push_back("dd"); }
+void leader_ddd(void) { fired.push_back("ddd"); }
+void leader_end(void) { ended++; }
+}
+
+class Leader : public TestFixture {
+   protected:
+    void SetUp() override {
+        fired.clear();
+        ended = 0;
+        // Releasing keys typed into the sequence sends empty reports
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    }
+
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    TestDriver driver;
+};
+
+#define LEAD 0
+#define A 1
+#define S 2
+#define D 3
+#define F 4
+
+TEST_F(Leader, AUniqueSequenceFiresImmediately) {
+    tap(LEAD);
+    tap(A);
+    EXPECT_TRUE(fired.empty());
+    press_key(S, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(fired, std::vector<std::string>{"as"});
+    EXPECT_EQ(ended, 1);
+    release_key(S, 0);
+    run_one_scan_loop();
+
+    idle_for(LEADER_TIMEOUT * 2);
+    EXPECT_EQ(fired.size(), 1u);
+    EXPECT_EQ(ended, 1);
+}
+
+TEST_F(Leader, APrefixFiresOnTimeout) {
+    tap(LEAD);
+    tap(D);
+    idle_for(LEADER_TIMEOUT - 10);
+    EXPECT_TRUE(fired.empty());
+    EXPECT_EQ(ended, 0);
+    idle_for(20);
+    EXPECT_EQ(fired, std::vector<std::string>{"d"});
+    EXPECT_EQ(ended, 1);
+}
+
+TEST_F(Leader, ALongerPrefixFiresOnTimeout) {
+    tap(LEAD);
+    tap(D);
+    tap(D);
+    EXPECT_TRUE(fired.empty());
+    idle_for(LEADER_TIMEOUT);
+    EXPECT_EQ(fired, std::vector<std::string>{"dd"});
+}
+
+TEST_F(Leader, ASequenceOfTheFullLengthFiresImmediately) {
+    tap(LEAD);
+    tap(D);
+    tap(D);
+    press_key(D, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(fired, std::vector<std::string>{"ddd"});
+    EXPECT_EQ(ended, 1);
+    release_key(D, 0);
+    run_one_scan_loop();
+
+    // The leader has ended, so the next key is typed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_D)));
+    tap(D);
+    EXPECT_EQ(fired.size(), 1u);
+}
+
+TEST_F(Leader, AKeyThatStartsNoSequenceEndsTheLeader) {
+    tap(LEAD);
+    tap(F);
+    EXPECT_TRUE(fired.empty());
+    EXPECT_EQ(ended, 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    tap(A);
+    idle_for(LEADER_TIMEOUT * 2);
+    EXPECT_TRUE(fired.empty());
+}
+
+TEST_F(Leader, AKeyThatContinuesNoSequenceEndsTheLeader) {
+    tap(LEAD);
+    tap(A);
+    tap(D);
+    EXPECT_TRUE(fired.empty());
+    EXPECT_EQ(ended, 1);
+    idle_for(LEADER_TIMEOUT * 2);
+    EXPECT_TRUE(fired.empty());
+}
@@ -0,0 +1,177 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+#include "mousekey.h"
+#include "mouse_accumulator.h"
+#include "ps2_mouse.h"
+#include "host.h"
+void advance_time(uint32_t ms);
+}
+
+class MouseAccumulator : public testing::Test {
+   protected:
+    void SetUp() override {
+        Instance = this;
+        host_set_driver(&driver);
+        mouse_accumulator_clear();
+        // Well past the last report of the test before
+        advance_time(1000);
+    }
+
+    void TearDown() override {
+        mousekey_clear();
+        mouse_accumulator_clear();
+        Instance = nullptr;
+    }
+
+    static uint8_t keyboard_leds(void) { return 0; }
+    static void    send_keyboard(report_keyboard_t* report) {}
+    static void    send_mouse(report_mouse_t* report) { Instance->reports.push_back(*report); }
+    static void    send_system(uint16_t data) {}
+    static void    send_consumer(uint16_t data) {}
+
+    void add(mouse_source_t source, int8_t x, int8_t y, uint8_t buttons = 0) {
+        report_mouse_t report = {.buttons = buttons, .x = x, .y = y};
+        mouse_accumulator_add(source, &report);
+    }
+
+    // Runs the task every millisecond
+    void run(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            mouse_accumulator_task();
+            advance_time(1);
+        }
+    }
+
+    static MouseAccumulator* Instance;
+
+    host_driver_t               driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+    std::vector<report_mouse_t> reports;
+};
+
+MouseAccumulator* MouseAccumulator::Instance = nullptr;
+
+TEST_F(MouseAccumulator, SendsNothingWithoutChanges) {
+    run(100);
+    EXPECT_EQ(reports.size(), 0u);
+    add(MOUSE_SOURCE_PS2, 0, 0);
+    run(100);
+    EXPECT_EQ(reports.size(), 0u);
+}
+
+TEST_F(MouseAccumulator, MergesMotionFromEverySource) {
+    add(MOUSE_SOURCE_PS2, 10, -5);
+    add(MOUSE_SOURCE_POINTING_DEVICE, 3, 7);
+    add(MOUSE_SOURCE_PS2, 1, 1);
+    run(1);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].x, 14);
+    EXPECT_EQ(reports[0].y, 3);
+}
+
+TEST_F(MouseAccumulator, SendsAtMostOnceAnInterval) {
+    for (uint8_t i = 0; i < 40; i++) {
+        add(MOUSE_SOURCE_POINTING_DEVICE, 1, 0);
+        run(1);
+    }
+    EXPECT_EQ(reports.size(), 40u / MOUSE_ACCUMULATOR_INTERVAL);
+    int32_t x = 0;
+    for (auto& report : reports) {
+        x += report.x;
+    }
+    run(MOUSE_ACCUMULATOR_INTERVAL);
+    EXPECT_EQ(x + reports.back().x, 40);
+}
+
+TEST_F(MouseAccumulator, SplitsLargeMotionAcrossReports) {
+    mouse_accumulator_move(300, -200, 0, 0);
+    run(MOUSE_ACCUMULATOR_INTERVAL * 3);
+    ASSERT_EQ(reports.size(), 3u);
+    EXPECT_EQ(reports[0].x, 127);
+    EXPECT_EQ(reports[0].y, -127);
+    EXPECT_EQ(reports[1].x, 127);
+    EXPECT_EQ(reports[1].y, -73);
+    EXPECT_EQ(reports[2].x, 46);
+    EXPECT_EQ(reports[2].y, 0);
+}
+
+TEST_F(MouseAccumulator, TakesTheWholePS2Movement) {
+    // Left button, X moved -212 and Y 200, as ps2_mouse_task passes them on
+    uint8_t status = (1 << PS2_MOUSE_BTN_LEFT) | (1 << PS2_MOUSE_X_SIGN);
+    int16_t x      = ps2_mouse_movement(status, 0x2C, PS2_MOUSE_X_SIGN, PS2_MOUSE_X_OVFLW);
+    int16_t y      = ps2_mouse_movement(status, 200, PS2_MOUSE_Y_SIGN, PS2_MOUSE_Y_OVFLW);
+    EXPECT_EQ(x, -212);
+    EXPECT_EQ(y, 200);
+    mouse_accumulator_move(x, -y, 0, 0);
+    mouse_accumulator_buttons(MOUSE_SOURCE_PS2, status & PS2_MOUSE_BTN_MASK);
+    run(MOUSE_ACCUMULATOR_INTERVAL * 2);
+    ASSERT_EQ(reports.size(), 2u);
+    EXPECT_EQ(reports[0].buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports[0].x, -127);
+    EXPECT_EQ(reports[0].y, -127);
+    EXPECT_EQ(reports[1].x, -85);
+    EXPECT_EQ(reports[1].y, -73);
+    mouse_accumulator_buttons(MOUSE_SOURCE_PS2, 0);
+    run(MOUSE_ACCUMULATOR_INTERVAL);
+
+    status = (1 << PS2_MOUSE_X_OVFLW) | (1 << PS2_MOUSE_Y_OVFLW) | (1 << PS2_MOUSE_Y_SIGN);
+    EXPECT_EQ(ps2_mouse_movement(status, 0, PS2_MOUSE_X_SIGN, PS2_MOUSE_X_OVFLW), 255);
+    EXPECT_EQ(ps2_mouse_movement(status, 0, PS2_MOUSE_Y_SIGN, PS2_MOUSE_Y_OVFLW), -256);
+}
+
+TEST_F(MouseAccumulator, KeepsTheButtonsOfEachSource) {
+    add(MOUSE_SOURCE_MOUSEKEY, 0, 0, MOUSE_BTN1);
+    run(1);
+    // A PS/2 report without buttons doesn't release the mousekey button
+    add(MOUSE_SOURCE_PS2, 5, 0, 0);
+    run(MOUSE_ACCUMULATOR_INTERVAL);
+    ASSERT_EQ(reports.size(), 2u);
+    EXPECT_EQ(reports[1].buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports[1].x, 5);
+
+    add(MOUSE_SOURCE_MOUSEKEY, 0, 0, 0);
+    run(MOUSE_ACCUMULATOR_INTERVAL);
+    ASSERT_EQ(reports.size(), 3u);
+    EXPECT_EQ(reports[2].buttons, 0);
+}
+
+TEST_F(MouseAccumulator, SendsAClickBetweenReports) {
+    add(MOUSE_SOURCE_PS2, 1, 0);
+    run(1);
+    // Pressed and released before the next report is due
+    add(MOUSE_SOURCE_PS2, 0, 0, MOUSE_BTN2);
+    add(MOUSE_SOURCE_PS2, 0, 0, 0);
+    run(MOUSE_ACCUMULATOR_INTERVAL * 2);
+    ASSERT_EQ(reports.size(), 3u);
+    EXPECT_EQ(reports[1].buttons, MOUSE_BTN2);
+    EXPECT_EQ(reports[2].buttons, 0);
+}
+
+TEST_F(MouseAccumulator, MousekeysGoThroughTheAccumulator) {
+    mousekey_on(KC_MS_BTN1);
+    mousekey_send();
+    add(MOUSE_SOURCE_PS2, 2, 0);
+    EXPECT_EQ(reports.size(), 0u);
+    run(1);
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports[0].x, 2);
+}
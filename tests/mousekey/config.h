@@ -0,0 +1,29 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define MATRIX_ROWS 1
+#define MATRIX_COLS 1
+
+#define MK_SMOOTH
+#define MK_SMOOTH_INTERVAL 10
+#define MK_SMOOTH_INITIAL_SPEED 50
+#define MK_SMOOTH_MAX_SPEED 1000
+#define MK_SMOOTH_TIME_TO_MAX 1000
+#define MK_SMOOTH_CURVE 0
+#define MK_SMOOTH_WHEEL_INITIAL_SPEED 10
+#define MK_SMOOTH_WHEEL_MAX_SPEED 10
@@ -0,0 +1,178 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+#include "mousekey.h"
+#include "host.h"
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Collects the mouse reports, and runs mousekey_task() every millisecond
+class Mousekey : public testing::Test {
+   protected:
+    void SetUp() override {
+        Instance = this;
+        set_time(0);
+        host_set_driver(&driver);
+        mousekey_clear();
+    }
+
+    void TearDown() override {
+        mousekey_clear();
+        Instance = nullptr;
+    }
+
+    static uint8_t keyboard_leds(void) { return 0; }
+    static void    send_keyboard(report_keyboard_t* report) {}
+    static void    send_mouse(report_mouse_t* report) { Instance->reports.push_back(*report); }
+    static void    send_system(uint16_t data) {}
+    static void    send_consumer(uint16_t data) {}
+
+    void press(uint8_t code) {
+        mousekey_on(code);
+        mousekey_send();
+    }
+
+    void release(uint8_t code) {
+        mousekey_off(code);
+        mousekey_send();
+    }
+
+    void run(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            mousekey_task();
+        }
+    }
+
+    int32_t sum_x(size_t from = 0) {
+        int32_t sum = 0;
+        for (size_t i = from; i < reports.size(); i++) sum += reports[i].x;
+        return sum;
+    }
+
+    static Mousekey* Instance;
+
+    host_driver_t               driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+    std::vector<report_mouse_t> reports;
+};
+
+Mousekey* Mousekey::Instance = nullptr;
+
+TEST_F(Mousekey, MovesAsSoonAsAKeyIsPressed) {
+    press(KC_MS_RIGHT);
+    EXPECT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].x, 1);
+
+    // Motion is only reported once
+    mousekey_send();
+    EXPECT_EQ(reports[1].x, 0);
+}
+
+TEST_F(Mousekey, BuildsUpSubPixelMotion) {
+    // Starting at 50 pixels a second, there is less than a pixel to move every 10 ms
+    press(KC_MS_RIGHT);
+    reports.clear();
+    run(60);
+    EXPECT_GE(reports.size(), 3u);
+    EXPECT_LT(reports.size(), 60u / MK_SMOOTH_INTERVAL);
+    for (auto& report : reports) {
+        EXPECT_EQ(report.x, 1);
+        EXPECT_EQ(report.y, 0);
+    }
+}
+
+TEST_F(Mousekey, ReportsAtMostOnceAnInterval) {
+    press(KC_MS_DOWN);
+    reports.clear();
+    run(MK_SMOOTH_TIME_TO_MAX + 200);
+    EXPECT_LE(reports.size(), (size_t)(MK_SMOOTH_TIME_TO_MAX + 200) / MK_SMOOTH_INTERVAL);
+
+    // At full speed, every interval moves the same distance
+    size_t last = reports.size() - 1;
+    EXPECT_EQ(reports[last].y, MK_SMOOTH_MAX_SPEED * MK_SMOOTH_INTERVAL / 1000);
+    EXPECT_EQ(reports[last - 1].y, reports[last].y);
+}
+
+TEST_F(Mousekey, DistanceFollowsTheSpeedCurve) {
+    // A linear ramp from 50 to 1000 pixels a second covers 525 pixels in the first second
+    press(KC_MS_RIGHT);
+    run(MK_SMOOTH_TIME_TO_MAX);
+    EXPECT_NEAR(sum_x(), 525, 10);
+
+    // Then a second at full speed
+    size_t from = reports.size();
+    run(1000);
+    EXPECT_NEAR(sum_x(from), MK_SMOOTH_MAX_SPEED, 2);
+}
+
+TEST_F(Mousekey, DiagonalsMoveTheSameDistance) {
+    press(KC_MS_LEFT);
+    press(KC_MS_UP);
+    run(MK_SMOOTH_TIME_TO_MAX + 1000);
+    size_t from = reports.size();
+    run(1000);
+    int32_t x = 0, y = 0;
+    for (size_t i = from; i < reports.size(); i++) {
+        x += reports[i].x;
+        y += reports[i].y;
+    }
+    EXPECT_NEAR(x, -MK_SMOOTH_MAX_SPEED * 0.707, 5);
+    EXPECT_NEAR(y, -MK_SMOOTH_MAX_SPEED * 0.707, 5);
+}
+
+TEST_F(Mousekey, StopsWhenReleased) {
+    press(KC_MS_RIGHT);
+    run(300);
+    release(KC_MS_RIGHT);
+    reports.clear();
+    run(300);
+    EXPECT_EQ(reports.size(), 0u);
+}
+
+TEST_F(Mousekey, AccelKeysSetAConstantSpeed) {
+    press(KC_MS_ACCEL1);
+    press(KC_MS_RIGHT);
+    size_t from = reports.size();
+    run(1000);
+    EXPECT_NEAR(sum_x(from), MK_SMOOTH_MAX_SPEED / 2, 2);
+}
+
+TEST_F(Mousekey, ScrollsAtTheWheelSpeed) {
+    press(KC_MS_WH_DOWN);
+    EXPECT_EQ(reports.back().v, -1);
+    reports.clear();
+    run(1000);
+    EXPECT_EQ(reports.size(), (size_t)MK_SMOOTH_WHEEL_MAX_SPEED);
+    for (auto& report : reports) {
+        EXPECT_EQ(report.v, -1);
+    }
+}
+
+TEST_F(Mousekey, ButtonsAreSentWhileMoving) {
+    press(KC_MS_RIGHT);
+    run(100);
+    press(KC_MS_BTN1);
+    EXPECT_EQ(reports.back().buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports.back().x, 0);
+    release(KC_MS_BTN1);
+    EXPECT_EQ(reports.back().buttons, 0);
+}
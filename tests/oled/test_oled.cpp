@@ -0,0 +1,275 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+extern "C" {
+#include "quantum.h"
+#include "oled_driver.h"
+#include "i2c_master.h"
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+}
+
+#define PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+// Enough of an SSD1306 in horizontal addressing mode to see what ends up
+// on the screen. Every data transfer takes a millisecond.
+class Oled : public testing::Test {
+   protected:
+    void SetUp() override {
+        Instance = this;
+        set_time(0);
+        i2c_fake_device = device;
+        memset(ram, 0xAA, sizeof(ram));
+        EXPECT_TRUE(oled_init(OLED_ROTATION_0));
+        render_all();
+        data_writes = 0;
+        data_bytes  = 0;
+    }
+
+    void TearDown() override {
+        i2c_fake_device = nullptr;
+        Instance        = nullptr;
+    }
+
+    static i2c_status_t device(uint8_t address, int16_t reg, uint8_t* data, uint16_t length) {
+        if (address != OLED_DISPLAY_ADDRESS << 1) {
+            return I2C_STATUS_ERROR;
+        }
+        if (reg == 0x40) {
+            Instance->write_data(data, length);
+        } else if (reg == -1 && length > 0 && data[0] == 0x00) {
+            Instance->run_commands(data + 1, length - 1);
+        }
+        return I2C_STATUS_SUCCESS;
+    }
+
+    void run_commands(const uint8_t* cmd, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            switch (cmd[i]) {
+                case 0x21:  // COLUMN_ADDR
+                    col_start = col = cmd[i + 1];
+                    col_end         = cmd[i + 2];
+                    i += 2;
+                    break;
+                case 0x22:  // PAGE_ADDR
+                    page_start = page = cmd[i + 1];
+                    page_end          = cmd[i + 2];
+                    i += 2;
+                    break;
+                case 0x81:
+                case 0x8D:
+                case 0xA8:
+                case 0xD3:
+                case 0xD5:
+                case 0xD9:
+                case 0xDA:
+                case 0xDB:
+                case 0x20:
+                    i += 1;
+                    break;
+                case 0x26:
+                case 0x27:
+                    i += 6;
+                    break;
+            }
+        }
+    }
+
+    void write_data(const uint8_t* data, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            ram[page][col] = data[i];
+            if (++col > col_end) {
+                col = col_start;
+                if (++page > page_end) {
+                    page = page_start;
+                }
+            }
+        }
+        data_writes++;
+        data_bytes += length;
+        advance_time(1);
+    }
+
+    void render_all() {
+        while (oled_dirty) {
+            oled_render();
+        }
+    }
+
+    void expect_screen_matches_buffer() {
+        for (uint8_t p = 0; p < PAGES; p++) {
+            for (uint8_t c = 0; c < OLED_DISPLAY_WIDTH; c++) {
+                if (ram[p][c] != oled_buffer[p * OLED_DISPLAY_WIDTH + c]) {
+                    ADD_FAILURE() << "page " << (int)p << " column " << (int)c;
+                    return;
+                }
+            }
+        }
+    }
+
+    static Oled* Instance;
+
+    uint8_t  ram[PAGES][OLED_DISPLAY_WIDTH];
+    uint8_t  col = 0, col_start = 0, col_end = OLED_DISPLAY_WIDTH - 1;
+    uint8_t  page = 0, page_start = 0, page_end = PAGES - 1;
+    uint32_t data_writes = 0;
+    uint32_t data_bytes  = 0;
+};
+
+Oled* Oled::Instance = nullptr;
+
+TEST_F(Oled, RendersTheBuffer) {
+    oled_write_ln("Layer: Base", false);
+    oled_write_ln("WPM: 042", true);
+    render_all();
+    expect_screen_matches_buffer();
+}
+
+TEST_F(Oled, SendsOnlyTheChangedColumns) {
+    oled_write("WPM: 042", false);
+    render_all();
+    data_bytes = 0;
+
+    // '4' -> '5' only changes some of the character's columns
+    oled_set_cursor(6, 0);
+    oled_write_char('5', false);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_GT(data_bytes, 0u);
+    EXPECT_LE(data_bytes, (uint32_t)OLED_FONT_WIDTH);
+}
+
+TEST_F(Oled, SendsACharacterAcrossTwoBlocks) {
+    // Columns 30 to 35 straddle the first two blocks
+    oled_set_cursor(5, 0);
+    oled_write_char('#', false);
+    EXPECT_EQ(oled_dirty, (OLED_BLOCK_TYPE)0x3);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_LE(data_bytes, (uint32_t)OLED_FONT_WIDTH);
+}
+
+TEST_F(Oled, UnchangedWritesSendNothing) {
+    oled_write_ln("Layer: Base", false);
+    render_all();
+    data_bytes = 0;
+    oled_set_cursor(0, 0);
+    oled_write_ln("Layer: Base", false);
+    EXPECT_EQ(oled_dirty, (OLED_BLOCK_TYPE)0);
+    render_all();
+    EXPECT_EQ(data_bytes, 0u);
+}
+
+TEST_F(Oled, RendersForTheTimeBudget) {
+    oled_clear();
+    oled_render();
+    EXPECT_EQ(data_writes, (uint32_t)OLED_RENDER_TIME);
+    oled_render();
+    EXPECT_EQ(data_writes, (uint32_t)OLED_RENDER_TIME * 2);
+    render_all();
+    EXPECT_EQ(data_writes, (uint32_t)OLED_BLOCK_COUNT);
+    expect_screen_matches_buffer();
+}
+
+TEST_F(Oled, CountsFramesAndBytesPerSecond) {
+    // Start a fresh second
+    advance_time(1000);
+    oled_task();
+    data_bytes = 0;
+
+    for (uint8_t i = 0; i < 20; i++) {
+        oled_set_cursor(0, 1);
+        oled_write_char('a' + i, false);
+        oled_task();
+        advance_time(10);
+    }
+    advance_time(1000);
+    oled_task();
+    EXPECT_EQ(oled_render_fps(), 20);
+    EXPECT_EQ(oled_render_bytes_per_second(), data_bytes);
+}
+
+TEST_F(Oled, FillsARectangleWithinPages) {
+    // Rows 4 to 11 straddle the first two pages
+    oled_fill_rect(10, 4, 3, 8, true);
+    EXPECT_EQ(oled_buffer[9], 0x00);
+    EXPECT_EQ(oled_buffer[10], 0xF0);
+    EXPECT_EQ(oled_buffer[12], 0xF0);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH + 12], 0x0F);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH + 13], 0x00);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_EQ(data_bytes, 6u);
+
+    data_bytes = 0;
+    oled_fill_rect(11, 5, 1, 2, false);
+    oled_write_pixel(11, 5, true);
+    EXPECT_EQ(oled_buffer[11], 0xB0);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_EQ(data_bytes, 1u);
+}
+
+TEST_F(Oled, SpritesSendOnlyTheChangedBytes) {
+    static const uint8_t sprite[2][4] = {{0x01, 0x02, 0x03, 0x04}, {0x10, 0x20, 0x30, 0x40}};
+    oled_write_sprite(&sprite[0][0], 40, 1, 4, 2);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH + 40], 0x01);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH * 2 + 43], 0x40);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_EQ(data_bytes, 8u);
+
+    // Drawing it again changes nothing
+    data_bytes = 0;
+    oled_write_sprite(&sprite[0][0], 40, 1, 4, 2);
+    EXPECT_EQ(oled_dirty, (OLED_BLOCK_TYPE)0);
+
+    // Clipped at the right edge
+    oled_write_sprite(&sprite[0][0], OLED_DISPLAY_WIDTH - 2, 0, 4, 1);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH - 1], 0x02);
+    EXPECT_EQ(oled_buffer[OLED_DISPLAY_WIDTH], 0x00);
+}
+
+TEST_F(Oled, DrawsCompressedAnimationFrames) {
+    // 8x2 frames: a literal, a repeat, then a skip in the second frame
+    static const uint8_t frame_0[] = {8, 2, 0x03, 0x11, 0x22, 0x33, 0x44, 0x80 | 10, 0xFF};
+    static const uint8_t frame_1[] = {8, 2, 0xC0 | 2, 0x80 | 0, 0x55, 0xC0 | 10};
+
+    oled_write_image_P(frame_0, 20, 1);
+    const uint8_t* row = &oled_buffer[OLED_DISPLAY_WIDTH + 20];
+    EXPECT_EQ(row[0], 0x11);
+    EXPECT_EQ(row[3], 0x44);
+    EXPECT_EQ(row[4], 0xFF);
+    EXPECT_EQ(row[OLED_DISPLAY_WIDTH + 7], 0xFF);
+    EXPECT_EQ(row[OLED_DISPLAY_WIDTH + 8], 0x00);
+    render_all();
+    data_bytes = 0;
+
+    oled_write_image_P(frame_1, 20, 1);
+    EXPECT_EQ(row[2], 0x33);
+    EXPECT_EQ(row[3], 0x55);
+    EXPECT_EQ(row[4], 0x55);
+    EXPECT_EQ(row[5], 0xFF);
+    render_all();
+    expect_screen_matches_buffer();
+    EXPECT_EQ(data_bytes, 2u);
+}
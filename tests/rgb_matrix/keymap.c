@@ -0,0 +1,46 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            {KC_ESC, KC_Q, KC_W, KC_E, KC_R, KC_T},
+            {KC_TAB, KC_A, KC_S, KC_D, KC_F, KC_G},
+            {KC_LSFT, KC_Z, KC_X, KC_C, KC_V, KC_B},
+            {KC_LCTL, KC_LGUI, KC_LALT, KC_SPC, KC_SPC, KC_ENT},
+        },
+};
+
+// A small board spread over the whole 224x64 effect space, so the
+// animations see the same distances as they would on a full size board
+led_config_t g_led_config = {{
+    {0, 1, 2, 3, 4, 5},
+    {6, 7, 8, 9, 10, 11},
+    {12, 13, 14, 15, 16, 17},
+    {18, 19, 20, 21, 22, 23},
+}, {
+    {0, 0}, {45, 0}, {90, 0}, {134, 0}, {179, 0}, {224, 0},
+    {0, 21}, {45, 21}, {90, 21}, {134, 21}, {179, 21}, {224, 21},
+    {0, 43}, {45, 43}, {90, 43}, {134, 43}, {179, 43}, {224, 43},
+    {0, 64}, {45, 64}, {90, 64}, {134, 64}, {179, 64}, {224, 64},
+}, {
+    1, 4, 4, 4, 4, 4,
+    1, 4, 4, 4, 4, 4,
+    1, 4, 4, 4, 4, 4,
+    1, 1, 1, 4, 4, 1,
+}};
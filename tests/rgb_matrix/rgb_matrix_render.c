@@ -0,0 +1,133 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rgb_matrix_render.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// Scan loops to wait for a flush, so an effect that stops flushing can't hang the render
+#define RGB_MATRIX_RENDER_FRAME_TIMEOUT 1000
+
+static const char *effect_names[] = {
+    "NONE",
+#define RGB_MATRIX_EFFECT(name, ...) #name,
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+static RGB      leds[DRIVER_LED_TOTAL];
+static uint16_t flushes;
+
+static void init(void) { memset(leds, 0, sizeof(leds)); }
+
+static void flush(void) { flushes++; }
+
+static void set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index >= 0 && index < DRIVER_LED_TOTAL) {
+        leds[index] = (RGB){.r = red, .g = green, .b = blue};
+    }
+}
+
+static void set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        set_color(i, red, green, blue);
+    }
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = init,
+    .flush         = flush,
+    .set_color     = set_color,
+    .set_color_all = set_color_all,
+};
+
+const char *rgb_matrix_render_effect_name(uint8_t mode) {
+    if (mode >= sizeof(effect_names) / sizeof(effect_names[0])) {
+        return "UNKNOWN";
+    }
+    return effect_names[mode];
+}
+
+static void render_key(keypos_t key, bool pressed) {
+    keyrecord_t record = {.event = {.key = key, .pressed = pressed, .time = timer_read() | 1}};
+    process_rgb_matrix(keymap_key_to_keycode(0, key), &record);
+}
+
+static void render_frame(void) {
+    uint16_t flushed = flushes;
+    for (uint16_t loops = 0; flushes == flushed && loops < RGB_MATRIX_RENDER_FRAME_TIMEOUT; loops++) {
+        rgb_matrix_task();
+        advance_time(1);
+    }
+}
+
+uint32_t rgb_matrix_render(uint8_t mode, uint16_t frames, RGB *strip) {
+    rgb_matrix_init();
+    rgb_matrix_config.enable = 1;
+    rgb_matrix_config.hsv    = (HSV){.h = 0, .s = UINT8_MAX, .v = UINT8_MAX};
+    rgb_matrix_config.speed  = UINT8_MAX / 2;
+
+    // Start on a 64k tick boundary, so the effect sees the same 16 bit
+    // animation time whatever was rendered before it. A blank frame takes
+    // up the jump in time, and makes the effect start from its init frame
+    // even when it was the last one rendered.
+    set_time((timer_read32() | UINT16_MAX) + 1);
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_NONE);
+    render_frame();
+    rgb_matrix_mode_noeeprom(mode);
+    srand(1);
+
+    // FNV-1a over every frame
+    uint32_t checksum = 2166136261u;
+    for (uint16_t frame = 0; frame < frames; frame++) {
+        if (frame % RGB_MATRIX_RENDER_HIT_INTERVAL == 0) {
+            // Step through the keys out of order, so hits land all over the board
+            uint8_t  hit = (frame / RGB_MATRIX_RENDER_HIT_INTERVAL * 7) % (MATRIX_ROWS * MATRIX_COLS);
+            keypos_t key = {.row = hit / MATRIX_COLS, .col = hit % MATRIX_COLS};
+            render_key(key, true);
+            render_key(key, false);
+        }
+
+        render_frame();
+
+        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+            checksum = (checksum ^ leds[i].r) * 16777619u;
+            checksum = (checksum ^ leds[i].g) * 16777619u;
+            checksum = (checksum ^ leds[i].b) * 16777619u;
+        }
+        if (strip) {
+            memcpy(&strip[frame * DRIVER_LED_TOTAL], leds, sizeof(leds));
+        }
+    }
+    return checksum;
+}
+
+bool rgb_matrix_render_write_strip(const char *path, const RGB *strip, uint16_t frames) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", DRIVER_LED_TOTAL, frames);
+    for (uint32_t i = 0; i < (uint32_t)frames * DRIVER_LED_TOTAL; i++) {
+        uint8_t pixel[3] = {strip[i].r, strip[i].g, strip[i].b};
+        fwrite(pixel, 1, sizeof(pixel), file);
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,34 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// Renders rgb_matrix effects off the keyboard. The driver behind it keeps
+// the last flushed frame, and key hits are fed in on a fixed schedule so
+// every run of an effect produces the same frames.
+
+#define RGB_MATRIX_RENDER_HIT_INTERVAL 12
+
+const char *rgb_matrix_render_effect_name(uint8_t mode);
+
+// Renders frames of an effect and returns a checksum of them. The frames are
+// copied to strip, one row of DRIVER_LED_TOTAL colors per frame, when given.
+uint32_t rgb_matrix_render(uint8_t mode, uint16_t frames, RGB *strip);
+
+// Writes a strip as a binary PPM image, one pixel per LED and one line per frame
+bool rgb_matrix_render_write_strip(const char *path, const RGB *strip, uint16_t frames);
@@ -0,0 +1,134 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix_render.h"
+}
+
+#define RENDER_FRAMES 128
+
+struct GoldenChecksum {
+    const char* effect;
+    uint32_t    checksum;
+};
+
+// Checksums of RENDER_FRAMES frames of each effect. Effects that draw with
+// rand() depend on the C library, so they are only checked for repeatability.
+static const GoldenChecksum golden_checksums[] = {
+    {"SOLID_COLOR", 0x91E4A9C5},
+    {"ALPHAS_MODS", 0x26DFC6C5},
+    {"GRADIENT_UP_DOWN", 0x12B801C5},
+    {"GRADIENT_LEFT_RIGHT", 0x264A91C5},
+    {"BREATHING", 0x26BE0735},
+    {"BAND_SAT", 0x882935A5},
+    {"BAND_VAL", 0xB498E6B5},
+    {"BAND_PINWHEEL_SAT", 0xB3EB7899},
+    {"BAND_PINWHEEL_VAL", 0x2203CDB3},
+    {"BAND_SPIRAL_SAT", 0x73553A8D},
+    {"BAND_SPIRAL_VAL", 0x0377FA4D},
+    {"CYCLE_ALL", 0x29C71B85},
+    {"CYCLE_LEFT_RIGHT", 0x5EC4D305},
+    {"CYCLE_UP_DOWN", 0xA00334A1},
+    {"RAINBOW_MOVING_CHEVRON", 0x18F3FB75},
+    {"CYCLE_OUT_IN", 0x3E8D830D},
+    {"CYCLE_OUT_IN_DUAL", 0xD764689D},
+    {"CYCLE_PINWHEEL", 0xC6724A73},
+    {"CYCLE_SPIRAL", 0x0B9EFA97},
+    {"DUAL_BEACON", 0x5C04DE99},
+    {"RAINBOW_BEACON", 0xC4F744B3},
+    {"RAINBOW_PINWHEELS", 0xE8DD6AFD},
+    {"TYPING_HEATMAP", 0xA0F9FFF6},
+    {"SOLID_REACTIVE_SIMPLE", 0x836AB614},
+    {"SOLID_REACTIVE", 0xD57E48D9},
+    {"SOLID_REACTIVE_WIDE", 0xDF7B6E42},
+    {"SOLID_REACTIVE_MULTIWIDE", 0xD8641562},
+    {"SOLID_REACTIVE_CROSS", 0xD288E64A},
+    {"SOLID_REACTIVE_MULTICROSS", 0xED90948F},
+    {"SOLID_REACTIVE_NEXUS", 0x6F15EAEC},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x4250F343},
+    {"SPLASH", 0xE284A573},
+    {"MULTISPLASH", 0x44E42ED4},
+    {"SOLID_SPLASH", 0xABAC2601},
+    {"SOLID_MULTISPLASH", 0x0D45FBEB},
+};
+
+static const char* random_effects[] = {"RAINDROPS", "JELLYBEAN_RAINDROPS", "DIGITAL_RAIN"};
+
+static const GoldenChecksum* find_golden(const char* effect) {
+    for (const GoldenChecksum& golden : golden_checksums) {
+        if (strcmp(golden.effect, effect) == 0) {
+            return &golden;
+        }
+    }
+    return nullptr;
+}
+
+static bool is_random(const char* effect) {
+    for (const char* random : random_effects) {
+        if (strcmp(random, effect) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class RgbMatrixRender : public testing::Test {};
+
+TEST_F(RgbMatrixRender, EffectsMatchGoldenChecksums) {
+    // Set RGB_MATRIX_RENDER_DIR to also get an image strip of every effect
+    const char*      strip_dir = getenv("RGB_MATRIX_RENDER_DIR");
+    std::vector<RGB> strip(RENDER_FRAMES * DRIVER_LED_TOTAL);
+
+    for (uint8_t mode = RGB_MATRIX_NONE + 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        const char* effect = rgb_matrix_render_effect_name(mode);
+        SCOPED_TRACE(effect);
+
+        auto     start    = std::chrono::steady_clock::now();
+        uint32_t checksum = rgb_matrix_render(mode, RENDER_FRAMES, strip.data());
+        auto     elapsed  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        printf("%-28s %8.2f us/frame  checksum 0x%08X\n", effect, elapsed / 1000.0 / RENDER_FRAMES, checksum);
+
+        if (strip_dir) {
+            std::string path = std::string(strip_dir) + "/" + effect + ".ppm";
+            EXPECT_TRUE(rgb_matrix_render_write_strip(path.c_str(), strip.data(), RENDER_FRAMES)) << path;
+        }
+
+        const GoldenChecksum* golden = find_golden(effect);
+        if (golden) {
+            EXPECT_EQ(checksum, golden->checksum);
+        } else if (is_random(effect)) {
+            EXPECT_EQ(checksum, rgb_matrix_render(mode, RENDER_FRAMES, nullptr));
+        } else {
+            ADD_FAILURE() << "No golden checksum, this render gives 0x" << std::hex << checksum;
+        }
+    }
+}
+
+TEST_F(RgbMatrixRender, RenderDoesNotDependOnPreviousEffect) {
+    uint32_t first = rgb_matrix_render(RGB_MATRIX_SPLASH, RENDER_FRAMES, nullptr);
+    for (uint8_t mode = RGB_MATRIX_NONE + 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        rgb_matrix_render(mode, RENDER_FRAMES / 4, nullptr);
+    }
+    EXPECT_EQ(first, rgb_matrix_render(RGB_MATRIX_SPLASH, RENDER_FRAMES, nullptr));
+}
@@ -0,0 +1,127 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstdio>
+
+extern "C" {
+#include "quantum.h"
+#include "ws2812.h"
+void advance_time(uint32_t ms);
+}
+
+// A bit-banged WS2812 transmit holds off interrupts for about 30us per LED
+#define WS2812_US_PER_LED 30
+
+class Rgblight : public testing::Test {
+   protected:
+    void SetUp() override {
+        is_rgblight_initialized = false;
+        rgblight_init();
+        rgblight_enable_noeeprom();
+        rgblight_sethsv_noeeprom(HSV_RED);
+    }
+
+    void reset_counts() {
+        ws2812_transmits = 0;
+        ws2812_leds_sent = 0;
+    }
+
+    // Runs rgblight for a while, returning how many frames the effect drew
+    uint32_t run_for(uint32_t ms) {
+        uint32_t frames = 0;
+        for (uint32_t i = 0; i < ms; i++) {
+            uint16_t last_timer = animation_status.last_timer;
+            rgblight_task();
+            if (animation_status.last_timer != last_timer) {
+                frames++;
+            }
+            advance_time(1);
+        }
+        return frames;
+    }
+
+    void report(const char* name, uint32_t frames) {
+        printf("%-16s %5u frames %5u transmits %8u us of transmit saved\n", name, frames, ws2812_transmits, (frames - ws2812_transmits) * RGBLED_NUM * WS2812_US_PER_LED);
+    }
+};
+
+TEST_F(Rgblight, RepeatedStaticColorIsNotSentAgain) {
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    reset_counts();
+
+    // A keymap that sets its layer colour on every scan
+    for (int i = 0; i < 1000; i++) {
+        rgblight_sethsv_noeeprom(HSV_RED);
+        rgblight_task();
+        advance_time(1);
+    }
+    report("static", 1000);
+    EXPECT_EQ(ws2812_transmits, 0u);
+
+    rgblight_sethsv_noeeprom(HSV_BLUE);
+    EXPECT_EQ(ws2812_transmits, 1u);
+    EXPECT_EQ(ws2812_leds_sent, (uint32_t)RGBLED_NUM);
+}
+
+TEST_F(Rgblight, ChangingTheClippingRangeSendsTheFrameAgain) {
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    reset_counts();
+
+    rgblight_set_clipping_range(0, RGBLED_NUM / 2);
+    rgblight_set();
+    EXPECT_EQ(ws2812_transmits, 1u);
+    EXPECT_EQ(ws2812_leds_sent, (uint32_t)RGBLED_NUM / 2);
+    rgblight_set_clipping_range(0, RGBLED_NUM);
+}
+
+TEST_F(Rgblight, SlowBreathingSkipsRepeatedFrames) {
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_BREATHING);
+    reset_counts();
+
+    uint32_t frames = run_for(10000);
+    report("breathing", frames);
+    EXPECT_GT(frames, 0u);
+    EXPECT_LT(ws2812_transmits, frames);
+}
+
+TEST_F(Rgblight, EffectsRunAtTheirInterval) {
+    struct {
+        const char* name;
+        uint8_t     mode;
+        uint16_t    interval;
+    } effects[] = {
+        {"breathing", RGBLIGHT_MODE_BREATHING + 1, 20},
+        {"rainbow mood", RGBLIGHT_MODE_RAINBOW_MOOD, 120},
+        {"rainbow swirl", RGBLIGHT_MODE_RAINBOW_SWIRL + 3, 50},
+        {"snake", RGBLIGHT_MODE_SNAKE + 4, 20},
+        {"knight", RGBLIGHT_MODE_KNIGHT + 2, 31},
+        {"christmas", RGBLIGHT_MODE_CHRISTMAS, RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL},
+        {"rgb test", RGBLIGHT_MODE_RGB_TEST, 1024},
+        {"alternating", RGBLIGHT_MODE_ALTERNATING, 500},
+    };
+
+    for (auto& effect : effects) {
+        SCOPED_TRACE(effect.name);
+        rgblight_mode_noeeprom(effect.mode);
+        reset_counts();
+
+        uint32_t frames = run_for(10000);
+        report(effect.name, frames);
+        EXPECT_NEAR(frames, 10000 / effect.interval, 1);
+        EXPECT_LE(ws2812_transmits, frames);
+    }
+}
@@ -0,0 +1,46 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Stands in for the GPIO of a real board, for tests that include it from
+// their config.h. A pin reads whatever was last put in gpio_fake_pins,
+// either by the test or by writePin.
+typedef uint8_t pin_t;
+
+#define GPIO_FAKE_PIN_COUNT 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern bool gpio_fake_pins[GPIO_FAKE_PIN_COUNT];
+#ifdef __cplusplus
+}
+#endif
+
+#define setPinInput(pin) ((void)(pin))
+#define setPinInputHigh(pin) ((void)(pin))
+#define setPinInputLow(pin) ((void)(pin))
+#define setPinOutput(pin) ((void)(pin))
+
+#define writePinHigh(pin) (gpio_fake_pins[pin] = true)
+#define writePinLow(pin) (gpio_fake_pins[pin] = false)
+#define writePin(pin, level) (gpio_fake_pins[pin] = (level))
+
+#define readPin(pin) gpio_fake_pins[pin]
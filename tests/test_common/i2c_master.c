@@ -0,0 +1,38 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_master.h"
+
+i2c_fake_device_t i2c_fake_device = 0;
+
+static i2c_status_t i2c_fake_transfer(uint8_t address, int16_t reg, uint8_t* data, uint16_t length) {
+    if (!i2c_fake_device) {
+        return I2C_STATUS_ERROR;
+    }
+    return i2c_fake_device(address, reg, data, length);
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_fake_transfer(address, -1, (uint8_t*)data, length); }
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_fake_transfer(address | 0x01, -1, data, length); }
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_fake_transfer(devaddr, regaddr, (uint8_t*)data, length); }
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) { return i2c_fake_transfer(devaddr | 0x01, regaddr, data, length); }
+
+void i2c_stop(void) {}
@@ -0,0 +1,29 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ws2812.h"
+
+uint32_t ws2812_transmits = 0;
+uint32_t ws2812_leds_sent = 0;
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    ws2812_transmits++;
+    ws2812_leds_sent += number_of_leds;
+}
+
+void ws2812_setleds_async(LED_TYPE *ledarray, uint16_t number_of_leds) { ws2812_setleds(ledarray, number_of_leds); }
+
+bool ws2812_busy(void) { return false; }
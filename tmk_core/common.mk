@@ -85,6 +85,11 @@ ifeq ($(strip $(MOUSEKEY_ENABLE)), yes)
     endif
 endif
 
+ifeq ($(strip $(MOUSE_ACCUMULATOR_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/mouse_accumulator.c
+    TMK_COMMON_DEFS += -DMOUSE_ACCUMULATOR_ENABLE
+endif
+
 ifeq ($(strip $(EXTRAKEY_ENABLE)), yes)
     TMK_COMMON_DEFS += -DEXTRAKEY_ENABLE
     SHARED_EP_ENABLE = yes
@@ -871,6 +871,7 @@ void unregister_code(uint8_t code) {
  */
 void tap_code(uint8_t code) {
     register_code(code);
+    flush_keyboard_report();
     if (code == KC_CAPS) {
         wait_ms(TAP_HOLD_CAPS_DELAY);
     } else {
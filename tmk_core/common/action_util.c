@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_layer.h"
 #include "timer.h"
 #include "keycode_config.h"
+#include <string.h>
 
 extern keymap_config_t keymap_config;
 
@@ -130,6 +131,92 @@ void clear_oneshot_layer_state(oneshot_fullfillment_t state) {
 bool is_oneshot_layer_active(void) { return get_oneshot_layer_state(); }
 #endif
 
+#ifdef KEYBOARD_REPORT_COALESCE
+static report_keyboard_t pending_report;
+static report_keyboard_t last_sent_report;
+static bool              report_pending     = false;
+static bool              report_sent        = false;
+static uint8_t           report_batch_depth = 0;
+
+static bool report_has_key_byte(report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) return true;
+    }
+    return false;
+}
+
+/** \brief Whether a key or mod changes in last, pending and next in a way the host would miss
+ *
+ * That is the case for anything that changes from the last report sent to the pending
+ * one and changes back in the next one, like a tapped key, or a key released and
+ * pressed again.
+ */
+static inline bool report_change_hidden(bool last, bool pending, bool next) { return pending != last && next == last; }
+
+/** \brief Whether replacing the pending report would hide a press or release from the host
+ */
+static bool pending_report_has_unsent_change(void) {
+    if ((pending_report.mods ^ last_sent_report.mods) & ~(keyboard_report->mods ^ last_sent_report.mods)) return true;
+#    ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            uint8_t last    = last_sent_report.nkro.bits[i];
+            uint8_t pending = pending_report.nkro.bits[i];
+            uint8_t next    = keyboard_report->nkro.bits[i];
+            if ((pending ^ last) & ~(next ^ last)) return true;
+        }
+        return false;
+    }
+#    endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = pending_report.keys[i];
+        if (key && report_change_hidden(report_has_key_byte(&last_sent_report, key), true, report_has_key_byte(keyboard_report, key))) return true;
+        key = last_sent_report.keys[i];
+        if (key && report_change_hidden(true, report_has_key_byte(&pending_report, key), report_has_key_byte(keyboard_report, key))) return true;
+    }
+    return false;
+}
+#endif
+
+/** \brief Begin a batch of keyboard report changes
+ *
+ * Until the matching end_keyboard_report_batch(), send_keyboard_report() only marks
+ * the report as pending, so that all changes made while processing a scan reach the
+ * host as a single report. Batches can be nested.
+ */
+void begin_keyboard_report_batch(void) {
+#ifdef KEYBOARD_REPORT_COALESCE
+    report_batch_depth++;
+#endif
+}
+
+/** \brief End a batch of keyboard report changes, sending the pending report if any
+ */
+void end_keyboard_report_batch(void) {
+#ifdef KEYBOARD_REPORT_COALESCE
+    if (report_batch_depth && --report_batch_depth == 0) {
+        flush_keyboard_report();
+    }
+#endif
+}
+
+/** \brief Send the pending keyboard report now
+ *
+ * For changes that the host must see in order, such as a modifier before the key it
+ * modifies, or a key press before a delay.
+ */
+void flush_keyboard_report(void) {
+#ifdef KEYBOARD_REPORT_COALESCE
+    if (!report_pending) return;
+    report_pending = false;
+    // The host state is unknown until the first report, so that is always sent
+    if (report_sent && memcmp(&pending_report, &last_sent_report, sizeof(report_keyboard_t)) == 0) return;
+    report_sent      = true;
+    last_sent_report = pending_report;
+    host_keyboard_send(&pending_report);
+#endif
+}
+
 /** \brief Send keyboard report
  *
  * FIXME: needs doc
@@ -153,7 +240,18 @@ void send_keyboard_report(void) {
     }
 
 #endif
+#ifdef KEYBOARD_REPORT_COALESCE
+    if (report_pending && pending_report_has_unsent_change()) {
+        flush_keyboard_report();
+    }
+    pending_report = *keyboard_report;
+    report_pending = true;
+    if (!report_batch_depth) {
+        flush_keyboard_report();
+    }
+#else
     host_keyboard_send(keyboard_report);
+#endif
 }
 
 /** \brief Get mods
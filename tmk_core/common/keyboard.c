@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "action_util.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -80,6 +81,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef OLED_DRIVER_ENABLE
 #    include "oled_driver.h"
 #endif
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+#    include "mouse_accumulator.h"
+#endif
 #ifdef VELOCIKEY_ENABLE
 #    include "velocikey.h"
 #endif
@@ -286,6 +293,9 @@ void keyboard_task(void) {
     uint8_t keys_processed = 0;
 #endif
 
+    // Send all keyboard report changes from this scan at once
+    begin_keyboard_report_batch();
+
 #if defined(OLED_DRIVER_ENABLE) && !defined(OLED_DISABLE_TIMEOUT)
     uint8_t ret = matrix_scan();
 #else
@@ -306,9 +316,13 @@ void keyboard_task(void) {
                 matrix_row_t col_mask = 1;
                 for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                     if (matrix_change & col_mask) {
-                        action_exec((keyevent_t){
+                        keyevent_t event = {
                             .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
+                        };
+                        action_exec(event);
+#ifdef VIA_ENABLE
+                        via_switch_matrix_event(event);
+#endif
                         // record a processed key
                         matrix_prev[r] ^= col_mask;
 #ifdef QMK_KEYS_PER_SCAN
@@ -331,6 +345,8 @@ void keyboard_task(void) {
 
 MATRIX_LOOP_END:
 
+    end_keyboard_report_batch();
+
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
@@ -349,6 +365,10 @@ MATRIX_LOOP_END:
     qwiic_task();
 #endif
 
+#ifdef VIA_ENABLE
+    via_task();
+#endif
+
 #ifdef OLED_DRIVER_ENABLE
     oled_task();
 #    ifndef OLED_DISABLE_TIMEOUT
@@ -357,6 +377,10 @@ MATRIX_LOOP_END:
 #    endif
 #endif
 
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_task();
+#endif
+
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
     mousekey_task();
@@ -386,6 +410,11 @@ MATRIX_LOOP_END:
     pointing_device_task();
 #endif
 
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+    // one report with the motion of every mouse source
+    mouse_accumulator_task();
+#endif
+
 #ifdef MIDI_ENABLE
     midi_task();
 #endif
@@ -0,0 +1,83 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mouse_accumulator.h"
+#include "timer.h"
+
+/* USB HID uses only values from -127 to 127 */
+#define MOUSE_REPORT_MAX 127
+
+static int32_t  acc_x = 0, acc_y = 0, acc_v = 0, acc_h = 0;
+static uint8_t  source_buttons[MOUSE_SOURCE_COUNT];
+static uint8_t  clicked      = 0;  // pressed since the last report
+static uint8_t  sent_buttons = 0;
+static uint16_t last_sent    = 0;
+
+void mouse_accumulator_move(int16_t x, int16_t y, int16_t v, int16_t h) {
+    acc_x += x;
+    acc_y += y;
+    acc_v += v;
+    acc_h += h;
+}
+
+void mouse_accumulator_buttons(mouse_source_t source, uint8_t buttons) {
+    clicked |= buttons & ~source_buttons[source];
+    source_buttons[source] = buttons;
+}
+
+void mouse_accumulator_add(mouse_source_t source, const report_mouse_t *report) {
+    mouse_accumulator_move(report->x, report->y, report->v, report->h);
+    mouse_accumulator_buttons(source, report->buttons);
+}
+
+void mouse_accumulator_clear(void) {
+    acc_x = acc_y = acc_v = acc_h = 0;
+    for (uint8_t i = 0; i < MOUSE_SOURCE_COUNT; i++) {
+        source_buttons[i] = 0;
+    }
+    clicked = 0;
+}
+
+// Takes as much of an axis as fits in a report
+static int8_t take(int32_t *acc) {
+    int8_t value = *acc > MOUSE_REPORT_MAX ? MOUSE_REPORT_MAX : (*acc < -MOUSE_REPORT_MAX ? -MOUSE_REPORT_MAX : *acc);
+    *acc -= value;
+    return value;
+}
+
+void mouse_accumulator_task(void) {
+    uint8_t buttons = clicked;
+    for (uint8_t i = 0; i < MOUSE_SOURCE_COUNT; i++) {
+        buttons |= source_buttons[i];
+    }
+    if (!acc_x && !acc_y && !acc_v && !acc_h && buttons == sent_buttons) {
+        return;
+    }
+    if (timer_elapsed(last_sent) < MOUSE_ACCUMULATOR_INTERVAL) {
+        return;
+    }
+
+    report_mouse_t report = {.buttons = buttons};
+    report.x              = take(&acc_x);
+    report.y              = take(&acc_y);
+    report.v              = take(&acc_v);
+    report.h              = take(&acc_h);
+    host_mouse_send(&report);
+
+    clicked      = 0;
+    sent_buttons = buttons;
+    last_sent    = timer_read();
+}
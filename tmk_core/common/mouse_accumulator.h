@@ -0,0 +1,75 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "host.h"
+#include "report.h"
+
+/* Mouse report accumulator
+ *
+ * Every mouse source (mousekeys, pointing device, PS/2, serial and ADB
+ * mice) adds its reports here instead of sending them. Motion is summed
+ * in wide integers, buttons are merged across sources, and
+ * mouse_accumulator_task() sends a single report at most every
+ * MOUSE_ACCUMULATOR_INTERVAL ms. Motion too large for one report is split
+ * over the following ones, and a button pressed and released between two
+ * reports is still sent as a click.
+ */
+
+#ifndef MOUSE_ACCUMULATOR_INTERVAL
+#    define MOUSE_ACCUMULATOR_INTERVAL 1
+#endif
+
+typedef enum {
+    MOUSE_SOURCE_MOUSEKEY,
+    MOUSE_SOURCE_POINTING_DEVICE,
+    MOUSE_SOURCE_PS2,
+    MOUSE_SOURCE_SERIAL,
+    MOUSE_SOURCE_ADB,
+    MOUSE_SOURCE_USER,
+    MOUSE_SOURCE_COUNT,
+} mouse_source_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adds the motion of a report, and sets the buttons its source holds
+void mouse_accumulator_add(mouse_source_t source, const report_mouse_t *report);
+
+// Adds motion too large for a report, e.g. from a high resolution sensor
+void mouse_accumulator_move(int16_t x, int16_t y, int16_t v, int16_t h);
+
+// Sets the buttons a source holds
+void mouse_accumulator_buttons(mouse_source_t source, uint8_t buttons);
+
+void mouse_accumulator_task(void);
+
+// Drops all motion and releases every button, without sending a report
+void mouse_accumulator_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Where mouse sources send their reports
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+#    define MOUSE_REPORT_SEND(source, report) mouse_accumulator_add(source, report)
+#else
+#    define MOUSE_REPORT_SEND(source, report) host_mouse_send(report)
+#endif
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "mousekey.h"
+#include "mouse_accumulator.h"
 
 inline int8_t times_inv_sqrt2(int8_t x) {
     // 181/256 is pretty close to 1/sqrt(2)
@@ -59,6 +60,8 @@ uint8_t mk_time_to_max = MOUSEKEY_TIME_TO_MAX;
 uint8_t mk_wheel_max_speed   = MOUSEKEY_WHEEL_MAX_SPEED;
 uint8_t mk_wheel_time_to_max = MOUSEKEY_WHEEL_TIME_TO_MAX;
 
+#    ifndef MK_SMOOTH
+
 static uint8_t move_unit(void) {
     uint16_t unit;
     if (mousekey_accel & (1 << 0)) {
@@ -196,6 +199,166 @@ void mousekey_off(uint8_t code) {
     if (mouse_report.x == 0 && mouse_report.y == 0 && mouse_report.v == 0 && mouse_report.h == 0) mousekey_repeat = 0;
 }
 
+#    else /* #ifndef MK_SMOOTH */
+
+/*
+ * Time based motion
+ *
+ * The speed follows how long the keys have been held, and the distance
+ * moved is the speed times the time since the last update. Distances are
+ * kept in 1/256ths of a pixel or scroll step, so slow speeds still move
+ * evenly, and a report is only sent when a whole unit has built up. Reports
+ * carry only the motion since the one before.
+ */
+static int8_t   mk_dir_x = 0, mk_dir_y = 0, mk_dir_v = 0, mk_dir_h = 0;
+static int16_t  mk_frac_x = 0, mk_frac_y = 0, mk_frac_v = 0, mk_frac_h = 0;
+static uint16_t mk_cursor_since = 0;
+static uint16_t mk_wheel_since  = 0;
+static uint16_t mk_updated      = 0;
+
+/* speed after being held for held ms, from initial towards max along the curve */
+static uint16_t smooth_speed(uint16_t held, uint16_t initial, uint16_t max, uint16_t time_to_max) {
+    if (mousekey_accel & (1 << 0)) return max / 4;
+    if (mousekey_accel & (1 << 1)) return max / 2;
+    if (mousekey_accel & (1 << 2)) return max;
+    if (held >= time_to_max) return max;
+
+    uint16_t progress = ((uint32_t)held << 8) / time_to_max;
+    uint16_t ramp     = progress;
+    for (uint8_t i = 0; i < MK_SMOOTH_CURVE; i++) {
+        ramp = ((uint32_t)ramp * progress) >> 8;
+    }
+    return initial + (((uint32_t)(max - initial) * ramp) >> 8);
+}
+
+/* adds distance to an axis, returning the whole units to report and keeping the rest */
+static int8_t smooth_move(int16_t *frac, int8_t dir, uint32_t distance, int8_t limit) {
+    if (distance > (uint32_t)limit << 8) distance = (uint32_t)limit << 8;
+    int16_t total = *frac + (dir < 0 ? -(int16_t)distance : (int16_t)distance);
+    int8_t  units = total / 256;
+    if (units > limit) units = limit;
+    if (units < -limit) units = -limit;
+    *frac = total - units * 256;
+    return units;
+}
+
+void mousekey_task(void) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, mk_updated);
+    if (elapsed < MK_SMOOTH_INTERVAL) {
+        return;
+    }
+    if (!mk_dir_x && !mk_dir_y && !mk_dir_v && !mk_dir_h) {
+        return;
+    }
+    mk_updated = now;
+    /* motion from longer stalls is dropped rather than jumped */
+    if (elapsed > UINT8_MAX) elapsed = UINT8_MAX;
+
+    if (mk_dir_x || mk_dir_y) {
+        uint16_t speed    = smooth_speed(TIMER_DIFF_16(now, mk_cursor_since), MK_SMOOTH_INITIAL_SPEED, MK_SMOOTH_MAX_SPEED, MK_SMOOTH_TIME_TO_MAX);
+        uint32_t distance = (((uint32_t)speed * elapsed << 8) + 500) / 1000;
+        /* diagonal move [1/sqrt(2)] */
+        if (mk_dir_x && mk_dir_y) distance = (distance * 181) >> 8;
+        if (mk_dir_x) mouse_report.x = smooth_move(&mk_frac_x, mk_dir_x, distance, MOUSEKEY_MOVE_MAX);
+        if (mk_dir_y) mouse_report.y = smooth_move(&mk_frac_y, mk_dir_y, distance, MOUSEKEY_MOVE_MAX);
+    }
+    if (mk_dir_v || mk_dir_h) {
+        uint16_t speed    = smooth_speed(TIMER_DIFF_16(now, mk_wheel_since), MK_SMOOTH_WHEEL_INITIAL_SPEED, MK_SMOOTH_WHEEL_MAX_SPEED, MK_SMOOTH_WHEEL_TIME_TO_MAX);
+        uint32_t distance = (((uint32_t)speed * elapsed << 8) + 500) / 1000;
+        if (mk_dir_v) mouse_report.v = smooth_move(&mk_frac_v, mk_dir_v, distance, MOUSEKEY_WHEEL_MAX);
+        if (mk_dir_h) mouse_report.h = smooth_move(&mk_frac_h, mk_dir_h, distance, MOUSEKEY_WHEEL_MAX);
+    }
+
+    /* until a whole unit builds up there is nothing to report */
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) {
+        mousekey_send();
+    }
+}
+
+/* starts moving along an axis, with one unit right away so the press isn't felt late */
+static void smooth_start(int8_t *dir, int16_t *frac, int8_t *report, int8_t direction, uint16_t *since, bool resting) {
+    if (!mk_dir_x && !mk_dir_y && !mk_dir_v && !mk_dir_h) mk_updated = timer_read();
+    if (resting) *since = timer_read();
+    if (!*dir) *frac = 0;
+    *dir    = direction;
+    *report = direction;
+}
+
+void mousekey_on(uint8_t code) {
+    bool cursor_resting = !mk_dir_x && !mk_dir_y;
+    bool wheel_resting  = !mk_dir_v && !mk_dir_h;
+    if (code == KC_MS_UP)
+        smooth_start(&mk_dir_y, &mk_frac_y, &mouse_report.y, -1, &mk_cursor_since, cursor_resting);
+    else if (code == KC_MS_DOWN)
+        smooth_start(&mk_dir_y, &mk_frac_y, &mouse_report.y, 1, &mk_cursor_since, cursor_resting);
+    else if (code == KC_MS_LEFT)
+        smooth_start(&mk_dir_x, &mk_frac_x, &mouse_report.x, -1, &mk_cursor_since, cursor_resting);
+    else if (code == KC_MS_RIGHT)
+        smooth_start(&mk_dir_x, &mk_frac_x, &mouse_report.x, 1, &mk_cursor_since, cursor_resting);
+    else if (code == KC_MS_WH_UP)
+        smooth_start(&mk_dir_v, &mk_frac_v, &mouse_report.v, 1, &mk_wheel_since, wheel_resting);
+    else if (code == KC_MS_WH_DOWN)
+        smooth_start(&mk_dir_v, &mk_frac_v, &mouse_report.v, -1, &mk_wheel_since, wheel_resting);
+    else if (code == KC_MS_WH_LEFT)
+        smooth_start(&mk_dir_h, &mk_frac_h, &mouse_report.h, -1, &mk_wheel_since, wheel_resting);
+    else if (code == KC_MS_WH_RIGHT)
+        smooth_start(&mk_dir_h, &mk_frac_h, &mouse_report.h, 1, &mk_wheel_since, wheel_resting);
+    else if (code == KC_MS_BTN1)
+        mouse_report.buttons |= MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons |= MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons |= MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons |= MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons |= MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel |= (1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel |= (1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel |= (1 << 2);
+}
+
+void mousekey_off(uint8_t code) {
+    if (code == KC_MS_UP && mk_dir_y < 0)
+        mk_dir_y = 0;
+    else if (code == KC_MS_DOWN && mk_dir_y > 0)
+        mk_dir_y = 0;
+    else if (code == KC_MS_LEFT && mk_dir_x < 0)
+        mk_dir_x = 0;
+    else if (code == KC_MS_RIGHT && mk_dir_x > 0)
+        mk_dir_x = 0;
+    else if (code == KC_MS_WH_UP && mk_dir_v > 0)
+        mk_dir_v = 0;
+    else if (code == KC_MS_WH_DOWN && mk_dir_v < 0)
+        mk_dir_v = 0;
+    else if (code == KC_MS_WH_LEFT && mk_dir_h < 0)
+        mk_dir_h = 0;
+    else if (code == KC_MS_WH_RIGHT && mk_dir_h > 0)
+        mk_dir_h = 0;
+    else if (code == KC_MS_BTN1)
+        mouse_report.buttons &= ~MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons &= ~MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons &= ~MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons &= ~MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons &= ~MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel &= ~(1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel &= ~(1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel &= ~(1 << 2);
+}
+
+#    endif /* #ifndef MK_SMOOTH */
+
 #else /* #ifndef MK_3_SPEED */
 
 enum { mkspd_unmod, mkspd_0, mkspd_1, mkspd_2, mkspd_COUNT };
@@ -343,14 +506,21 @@ void mousekey_off(uint8_t code) {
 
 void mousekey_send(void) {
     mousekey_debug();
-    host_mouse_send(&mouse_report);
+    MOUSE_REPORT_SEND(MOUSE_SOURCE_MOUSEKEY, &mouse_report);
     last_timer = timer_read();
+#if defined(MK_SMOOTH) && !defined(MK_3_SPEED)
+    /* motion is sent once, the next report only carries what was added since */
+    mouse_report.x = mouse_report.y = mouse_report.v = mouse_report.h = 0;
+#endif
 }
 
 void mousekey_clear(void) {
     mouse_report    = (report_mouse_t){};
     mousekey_repeat = 0;
     mousekey_accel  = 0;
+#if defined(MK_SMOOTH) && !defined(MK_3_SPEED)
+    mk_dir_x = mk_dir_y = mk_dir_v = mk_dir_h = 0;
+#endif
 }
 
 static void mousekey_debug(void) {
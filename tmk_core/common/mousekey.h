@@ -62,6 +62,38 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        define MOUSEKEY_WHEEL_TIME_TO_MAX 40
 #    endif
 
+/* time based motion, speeds are per second and times in milliseconds */
+#    ifdef MK_SMOOTH
+#        ifndef MK_SMOOTH_INTERVAL
+#            ifdef USB_POLLING_INTERVAL_MS
+#                define MK_SMOOTH_INTERVAL USB_POLLING_INTERVAL_MS
+#            else
+#                define MK_SMOOTH_INTERVAL 10
+#            endif
+#        endif
+#        ifndef MK_SMOOTH_INITIAL_SPEED
+#            define MK_SMOOTH_INITIAL_SPEED 100
+#        endif
+#        ifndef MK_SMOOTH_MAX_SPEED
+#            define MK_SMOOTH_MAX_SPEED 1600
+#        endif
+#        ifndef MK_SMOOTH_TIME_TO_MAX
+#            define MK_SMOOTH_TIME_TO_MAX 1000
+#        endif
+#        ifndef MK_SMOOTH_CURVE
+#            define MK_SMOOTH_CURVE 1
+#        endif
+#        ifndef MK_SMOOTH_WHEEL_INITIAL_SPEED
+#            define MK_SMOOTH_WHEEL_INITIAL_SPEED 10
+#        endif
+#        ifndef MK_SMOOTH_WHEEL_MAX_SPEED
+#            define MK_SMOOTH_WHEEL_MAX_SPEED 60
+#        endif
+#        ifndef MK_SMOOTH_WHEEL_TIME_TO_MAX
+#            define MK_SMOOTH_WHEEL_TIME_TO_MAX 1000
+#        endif
+#    endif
+
 #else /* #ifndef MK_3_SPEED */
 
 #    ifndef MK_C_OFFSET_UNMOD
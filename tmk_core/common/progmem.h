@@ -8,6 +8,7 @@
 #    define pgm_read_byte(p) *((unsigned char*)(p))
 #    define pgm_read_word(p) *((uint16_t*)(p))
 #    define pgm_read_dword(p) *((uint32_t*)(p))
+#    define pgm_read_ptr(p) *((void**)(p))
 #endif
 
 #endif
@@ -25,6 +25,7 @@
  *   makes the assumption this is safe to avoid littering with preprocessor directives.
  */
 
+#include <string.h>
 #include "ch.h"
 #include "hal.h"
 
@@ -75,6 +76,164 @@ report_mouse_t mouse_report_blank = {0};
 uint8_t extra_report_blank[3] = {0};
 #endif /* EXTRAKEY_ENABLE */
 
+/* ---------------------------------------------------------
+ *                 HID IN report queues
+ * ---------------------------------------------------------
+ * Reports are queued per endpoint and sent from the IN
+ * callback of the previous one, so submitting a report never
+ * waits for the host to poll the endpoint.
+ */
+
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+#define USB_REPORT_SLOT_SIZE SHARED_EPSIZE
+
+typedef struct {
+    uint8_t data[USB_REPORT_SLOT_SIZE];
+    uint8_t size;
+} usb_report_slot_t;
+
+typedef struct {
+    usb_report_slot_t slots[USB_REPORT_QUEUE_SIZE];
+    uint8_t           head;
+    uint8_t           count;
+    bool              in_flight;     /* the head slot is being transmitted */
+    bool              has_report_id; /* reports of different kinds are told apart by their first byte */
+    /* statistics */
+    uint8_t  max_depth;
+    uint16_t merged;
+    uint16_t dropped;
+    bool     stats_changed;
+} usb_report_queue_t;
+
+#ifndef KEYBOARD_SHARED_EP
+static usb_report_queue_t kbd_report_queue = {.has_report_id = false};
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static usb_report_queue_t mouse_report_queue = {.has_report_id = false};
+#endif
+#ifdef SHARED_EP_ENABLE
+static usb_report_queue_t shared_report_queue = {.has_report_id = true};
+#endif
+
+static usb_report_queue_t *report_queue_get(usbep_t ep) {
+#ifndef KEYBOARD_SHARED_EP
+    if (ep == KEYBOARD_IN_EPNUM) return &kbd_report_queue;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    if (ep == MOUSE_IN_EPNUM) return &mouse_report_queue;
+#endif
+#ifdef SHARED_EP_ENABLE
+    if (ep == SHARED_IN_EPNUM) return &shared_report_queue;
+#endif
+    return NULL;
+}
+
+/* Start transmitting the report at the head of the queue, if the endpoint is free.
+ * Must be called in locked state */
+static void report_queue_kick_i(usbep_t ep, usb_report_queue_t *queue) {
+    if (queue->in_flight || !queue->count) return;
+    /* the idle timer may be resending the last report, its IN callback will kick us again */
+    if (usbGetTransmitStatusI(&USB_DRIVER, ep)) return;
+
+    usb_report_slot_t *slot = &queue->slots[queue->head];
+    queue->in_flight        = true;
+    usbStartTransmitI(&USB_DRIVER, ep, slot->data, slot->size);
+}
+
+/* Find the newest report waiting in the queue that the given one supersedes.
+ * Must be called in locked state */
+static usb_report_slot_t *report_queue_find_merge_slot(usb_report_queue_t *queue, const uint8_t *data) {
+    uint8_t first = queue->in_flight ? 1 : 0;
+
+    for (uint8_t i = queue->count; i > first; i--) {
+        usb_report_slot_t *slot = &queue->slots[(queue->head + i - 1) % USB_REPORT_QUEUE_SIZE];
+        if (!queue->has_report_id || slot->data[0] == data[0]) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/* Queue a report for sending, never waits.
+ * If the queue is full, the report replaces the newest waiting report of the
+ * same kind (reports carry the whole state, so the latest one wins), or is
+ * dropped if there is none.
+ * Must be called in locked state */
+static void report_queue_push_i(usbep_t ep, const uint8_t *data, uint8_t size) {
+    usb_report_queue_t *queue = report_queue_get(ep);
+    usb_report_slot_t * slot;
+
+    if (!queue) return;
+
+    if (queue->count < USB_REPORT_QUEUE_SIZE) {
+        slot = &queue->slots[(queue->head + queue->count) % USB_REPORT_QUEUE_SIZE];
+        queue->count++;
+        if (queue->count > queue->max_depth) {
+            queue->max_depth     = queue->count;
+            queue->stats_changed = true;
+        }
+    } else {
+        slot = report_queue_find_merge_slot(queue, data);
+        queue->stats_changed = true;
+        if (!slot) {
+            queue->dropped++;
+            return;
+        }
+        queue->merged++;
+    }
+
+    memcpy(slot->data, data, size);
+    slot->size = size;
+    report_queue_kick_i(ep, queue);
+}
+
+/* A report has made it IN: release its slot and send the next one.
+ * Called from ISR, unlocked state */
+static void report_queue_in_cb(USBDriver *usbp, usbep_t ep) {
+    (void)usbp;
+    osalSysLockFromISR();
+    usb_report_queue_t *queue = report_queue_get(ep);
+    if (queue) {
+        if (queue->in_flight) {
+            queue->in_flight = false;
+            queue->head      = (queue->head + 1) % USB_REPORT_QUEUE_SIZE;
+            queue->count--;
+        }
+        report_queue_kick_i(ep, queue);
+    }
+    osalSysUnlockFromISR();
+}
+
+/* Drop all queued reports, e.g. on USB reset.
+ * Must be called in locked state */
+static void report_queue_reset_i(void) {
+#ifndef KEYBOARD_SHARED_EP
+    kbd_report_queue.head = kbd_report_queue.count = 0;
+    kbd_report_queue.in_flight                     = false;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    mouse_report_queue.head = mouse_report_queue.count = 0;
+    mouse_report_queue.in_flight                       = false;
+#endif
+#ifdef SHARED_EP_ENABLE
+    shared_report_queue.head = shared_report_queue.count = 0;
+    shared_report_queue.in_flight                        = false;
+#endif
+}
+
+/* Print the queue statistics to the debug console when they change.
+ * Not callable from ISR or locked state */
+static void report_queue_print_stats(usbep_t ep, const char *name) {
+    usb_report_queue_t *queue = report_queue_get(ep);
+
+    if (!queue || !queue->stats_changed) return;
+    queue->stats_changed = false;
+    dprintf("%s report queue: max depth %u/%u, merged %u, dropped %u\n", name, queue->max_depth, USB_REPORT_QUEUE_SIZE, queue->merged, queue->dropped);
+}
+
 /* ---------------------------------------------------------
  *            Descriptors and USB driver objects
  * ---------------------------------------------------------
@@ -329,6 +488,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
         case USB_EVENT_UNCONFIGURED:
             /* Falls into.*/
         case USB_EVENT_RESET:
+            osalSysLockFromISR();
+            report_queue_reset_i();
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -565,11 +727,7 @@ void init_usb_driver(USBDriver *usbp) {
  */
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
-void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
-}
+void kbd_in_cb(USBDriver *usbp, usbep_t ep) { report_queue_in_cb(usbp, ep); }
 #endif
 
 /* start-of-frame handler
@@ -597,7 +755,7 @@ static void keyboard_idle_timer_cb(void *arg) {
     if (keyboard_idle && keyboard_protocol) {
 #endif /* NKRO_ENABLE */
         /* TODO: are we sure we want the KBD_ENDPOINT? */
-        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
+        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM) && !report_queue_get(KEYBOARD_IN_EPNUM)->count) {
             usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)&keyboard_report_sent, KEYBOARD_EPSIZE);
         }
         /* rearm the timer */
@@ -612,7 +770,7 @@ static void keyboard_idle_timer_cb(void *arg) {
 /* LED status */
 uint8_t keyboard_leds(void) { return keyboard_led_stats; }
 
-/* prepare and start sending a report IN
+/* queue a report to be sent IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
     osalSysLock();
@@ -622,41 +780,10 @@ void send_keyboard(report_keyboard_t *report) {
 
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        report_queue_push_i(SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
         uint8_t *data, size;
         if (keyboard_protocol) {
             data = (uint8_t *)report;
@@ -665,12 +792,19 @@ void send_keyboard(report_keyboard_t *report) {
             data = &report->mods;
             size = 8;
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
+        report_queue_push_i(KEYBOARD_IN_EPNUM, data, size);
     }
     keyboard_report_sent = *report;
 
 unlock:
     osalSysUnlock();
+
+    if (debug_keyboard) {
+        report_queue_print_stats(KEYBOARD_IN_EPNUM, "keyboard");
+#if defined(NKRO_ENABLE) && !defined(KEYBOARD_SHARED_EP)
+        report_queue_print_stats(SHARED_IN_EPNUM, "shared");
+#endif
+    }
 }
 
 /* ---------------------------------------------------------
@@ -682,31 +816,19 @@ unlock:
 
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
-void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
-}
+void mouse_in_cb(USBDriver *usbp, usbep_t ep) { report_queue_in_cb(usbp, ep); }
 #    endif
 
 void send_mouse(report_mouse_t *report) {
     osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
+    if (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE) {
+        report_queue_push_i(MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
     }
+    osalSysUnlock();
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, MS2ST(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
+    if (debug_mouse) {
+        report_queue_print_stats(MOUSE_IN_EPNUM, "mouse");
     }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
 }
 
 #else  /* MOUSE_ENABLE */
@@ -719,11 +841,7 @@ void send_mouse(report_mouse_t *report) { (void)report; }
  */
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
-void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
-}
+void shared_in_cb(USBDriver *usbp, usbep_t ep) { report_queue_in_cb(usbp, ep); }
 #endif
 
 /* ---------------------------------------------------------
@@ -741,8 +859,12 @@ static void send_extra_report(uint8_t report_id, uint16_t data) {
 
     report_extra_t report = {.report_id = report_id, .usage = data};
 
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
+    report_queue_push_i(SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
     osalSysUnlock();
+
+    if (debug_keyboard) {
+        report_queue_print_stats(SHARED_IN_EPNUM, "shared");
+    }
 }
 
 void send_system(uint16_t data) { send_extra_report(REPORT_ID_SYSTEM, data); }
@@ -37,6 +37,7 @@
 */
 
 #include "report.h"
+#include <string.h>
 #include "host.h"
 #include "host_driver.h"
 #include "keyboard.h"
@@ -552,13 +553,133 @@ void EVENT_USB_Device_ControlRequest(void) {
  */
 static uint8_t keyboard_leds(void) { return keyboard_led_stats; }
 
+/*******************************************************************************
+ * HID IN report queues
+ *
+ * Reports are queued per endpoint and written whenever the endpoint bank is
+ * free, so submitting a report never waits for the host to poll it.
+ ******************************************************************************/
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 3
+#endif
+
+typedef struct {
+    uint8_t *data;      /* USB_REPORT_QUEUE_SIZE slots of slot_size bytes */
+    uint8_t  slot_size;
+    uint8_t  ep;
+    bool     has_report_id; /* reports of different kinds are told apart by their first byte */
+    uint8_t  head;
+    uint8_t  count;
+    uint8_t  size[USB_REPORT_QUEUE_SIZE];
+} report_queue_t;
+
+#ifndef KEYBOARD_SHARED_EP
+static uint8_t        keyboard_queue_data[USB_REPORT_QUEUE_SIZE][KEYBOARD_EPSIZE];
+static report_queue_t keyboard_queue = {(uint8_t *)keyboard_queue_data, KEYBOARD_EPSIZE, KEYBOARD_IN_EPNUM, false};
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static uint8_t        mouse_queue_data[USB_REPORT_QUEUE_SIZE][MOUSE_EPSIZE];
+static report_queue_t mouse_queue = {(uint8_t *)mouse_queue_data, MOUSE_EPSIZE, MOUSE_IN_EPNUM, false};
+#endif
+#ifdef SHARED_EP_ENABLE
+static uint8_t        shared_queue_data[USB_REPORT_QUEUE_SIZE][SHARED_EPSIZE];
+static report_queue_t shared_queue = {(uint8_t *)shared_queue_data, SHARED_EPSIZE, SHARED_IN_EPNUM, true};
+#endif
+
+static report_queue_t *report_queue_get(uint8_t ep) {
+#ifndef KEYBOARD_SHARED_EP
+    if (ep == KEYBOARD_IN_EPNUM) return &keyboard_queue;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    if (ep == MOUSE_IN_EPNUM) return &mouse_queue;
+#endif
+#ifdef SHARED_EP_ENABLE
+    if (ep == SHARED_IN_EPNUM) return &shared_queue;
+#endif
+    return NULL;
+}
+
+static inline uint8_t *report_queue_slot(report_queue_t *queue, uint8_t index) { return queue->data + ((queue->head + index) % USB_REPORT_QUEUE_SIZE) * queue->slot_size; }
+
+/** \brief Write queued reports while the endpoint bank is free
+ */
+static void report_queue_flush(report_queue_t *queue) {
+    if (!queue->count) return;
+
+    if (USB_DeviceState != DEVICE_STATE_Configured) {
+        queue->count = 0;
+        return;
+    }
+
+    uint8_t prev_ep = Endpoint_GetCurrentEndpoint();
+    Endpoint_SelectEndpoint(queue->ep);
+    while (queue->count && Endpoint_IsReadWriteAllowed()) {
+        Endpoint_Write_Stream_LE(report_queue_slot(queue, 0), queue->size[queue->head], NULL);
+        Endpoint_ClearIN();
+        queue->head = (queue->head + 1) % USB_REPORT_QUEUE_SIZE;
+        queue->count--;
+    }
+    Endpoint_SelectEndpoint(prev_ep);
+}
+
+/** \brief Queue a report and try to send it right away
+ *
+ * If the queue is full, the report replaces the newest queued report of the same
+ * kind, since reports carry the whole state and the latest one wins. Otherwise
+ * it is dropped.
+ */
+static void report_queue_push(uint8_t ep, const void *data, uint8_t size) {
+    report_queue_t *queue = report_queue_get(ep);
+    uint8_t *       slot  = NULL;
+
+    if (!queue) return;
+
+    report_queue_flush(queue);
+
+    if (queue->count < USB_REPORT_QUEUE_SIZE) {
+        slot = report_queue_slot(queue, queue->count);
+        queue->count++;
+    } else {
+        for (uint8_t i = queue->count; i > 0; i--) {
+            uint8_t *candidate = report_queue_slot(queue, i - 1);
+            if (!queue->has_report_id || candidate[0] == ((const uint8_t *)data)[0]) {
+                slot = candidate;
+                break;
+            }
+        }
+        if (!slot) {
+            dprintf("report queue %u: full, dropped\n", ep);
+            return;
+        }
+    }
+
+    memcpy(slot, data, size);
+    queue->size[(slot - queue->data) / queue->slot_size] = size;
+    report_queue_flush(queue);
+}
+
+/** \brief Send any reports still waiting for their endpoint
+ *
+ * Called from the main loop, next to USB_USBTask().
+ */
+static void report_queue_task(void) {
+#ifndef KEYBOARD_SHARED_EP
+    report_queue_flush(&keyboard_queue);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    report_queue_flush(&mouse_queue);
+#endif
+#ifdef SHARED_EP_ENABLE
+    report_queue_flush(&shared_queue);
+#endif
+}
+
 /** \brief Send Keyboard
  *
  * FIXME: Needs doc
  */
 static void send_keyboard(report_keyboard_t *report) {
-    uint8_t timeout = 255;
-    uint8_t where   = where_to_send();
+    uint8_t where = where_to_send();
 
 #ifdef BLUETOOTH_ENABLE
     if (where == OUTPUT_BLUETOOTH || where == OUTPUT_USB_AND_BT) {
@@ -597,21 +718,13 @@ static void send_keyboard(report_keyboard_t *report) {
         size = sizeof(struct nkro_report);
     }
 #endif
-    Endpoint_SelectEndpoint(ep);
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
     /* If we're in Boot Protocol, don't send any report ID or other funky fields */
     if (!keyboard_protocol) {
-        Endpoint_Write_Stream_LE(&report->mods, 8, NULL);
+        report_queue_push(ep, &report->mods, 8);
     } else {
-        Endpoint_Write_Stream_LE(report, size, NULL);
+        report_queue_push(ep, report, size);
     }
 
-    /* Finalize the stream transfer to send the last packet */
-    Endpoint_ClearIN();
-
     keyboard_report_sent = *report;
 }
 
@@ -621,8 +734,7 @@ static void send_keyboard(report_keyboard_t *report) {
  */
 static void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    uint8_t timeout = 255;
-    uint8_t where   = where_to_send();
+    uint8_t where = where_to_send();
 
 #    ifdef BLUETOOTH_ENABLE
     if (where == OUTPUT_BLUETOOTH || where == OUTPUT_USB_AND_BT) {
@@ -647,18 +759,7 @@ static void send_mouse(report_mouse_t *report) {
         return;
     }
 
-    /* Select the Mouse Report Endpoint */
-    Endpoint_SelectEndpoint(MOUSE_IN_EPNUM);
-
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    /* Write Mouse Report Data */
-    Endpoint_Write_Stream_LE(report, sizeof(report_mouse_t), NULL);
-
-    /* Finalize the stream transfer to send the last packet */
-    Endpoint_ClearIN();
+    report_queue_push(MOUSE_IN_EPNUM, report, sizeof(report_mouse_t));
 #endif
 }
 
@@ -668,19 +769,10 @@ static void send_mouse(report_mouse_t *report) {
  */
 static void send_system(uint16_t data) {
 #ifdef EXTRAKEY_ENABLE
-    uint8_t timeout = 255;
-
     if (USB_DeviceState != DEVICE_STATE_Configured) return;
 
     report_extra_t r = {.report_id = REPORT_ID_SYSTEM, .usage = data - SYSTEM_POWER_DOWN + 1};
-    Endpoint_SelectEndpoint(SHARED_IN_EPNUM);
-
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    Endpoint_Write_Stream_LE(&r, sizeof(report_extra_t), NULL);
-    Endpoint_ClearIN();
+    report_queue_push(SHARED_IN_EPNUM, &r, sizeof(report_extra_t));
 #endif
 }
 
@@ -690,8 +782,7 @@ static void send_system(uint16_t data) {
  */
 static void send_consumer(uint16_t data) {
 #ifdef EXTRAKEY_ENABLE
-    uint8_t timeout = 255;
-    uint8_t where   = where_to_send();
+    uint8_t where = where_to_send();
 
 #    ifdef BLUETOOTH_ENABLE
     if (where == OUTPUT_BLUETOOTH || where == OUTPUT_USB_AND_BT) {
@@ -730,14 +821,7 @@ static void send_consumer(uint16_t data) {
     }
 
     report_extra_t r = {.report_id = REPORT_ID_CONSUMER, .usage = data};
-    Endpoint_SelectEndpoint(SHARED_IN_EPNUM);
-
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    Endpoint_Write_Stream_LE(&r, sizeof(report_extra_t), NULL);
-    Endpoint_ClearIN();
+    report_queue_push(SHARED_IN_EPNUM, &r, sizeof(report_extra_t));
 #endif
 }
 
@@ -1011,6 +1095,8 @@ int main(void) {
         raw_hid_task();
 #endif
 
+        report_queue_task();
+
 #if !defined(INTERRUPT_CONTROL_ENDPOINT)
         USB_USBTask();
 #endif
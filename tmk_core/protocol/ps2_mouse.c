@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <util/delay.h>
 #include "ps2_mouse.h"
 #include "host.h"
+#include "mouse_accumulator.h"
 #include "timer.h"
 #include "print.h"
 #include "report.h"
@@ -73,12 +74,14 @@ void ps2_mouse_task(void) {
     extern int     tp_buttons;
 
     /* receives packet from mouse */
-    uint8_t rcv;
+    uint8_t rcv, x, y;
     rcv = ps2_host_send(PS2_MOUSE_READ_DATA);
     if (rcv == PS2_ACK) {
         mouse_report.buttons = ps2_host_recv_response() | tp_buttons;
-        mouse_report.x       = ps2_host_recv_response() * PS2_MOUSE_X_MULTIPLIER;
-        mouse_report.y       = ps2_host_recv_response() * PS2_MOUSE_Y_MULTIPLIER;
+        x                    = ps2_host_recv_response();
+        y                    = ps2_host_recv_response();
+        mouse_report.x       = x * PS2_MOUSE_X_MULTIPLIER;
+        mouse_report.y       = y * PS2_MOUSE_Y_MULTIPLIER;
 #ifdef PS2_MOUSE_ENABLE_SCROLLING
         mouse_report.v = -(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK) * PS2_MOUSE_V_MULTIPLIER;
 #endif
@@ -94,6 +97,17 @@ void ps2_mouse_task(void) {
         ps2_mouse_print_report(&mouse_report);
 #endif
         buttons_prev = mouse_report.buttons;
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+        // The accumulator takes the whole 9-bit movement, not the clipped report
+        int16_t move_x = ps2_mouse_movement(mouse_report.buttons, x, PS2_MOUSE_X_SIGN, PS2_MOUSE_X_OVFLW) * PS2_MOUSE_X_MULTIPLIER;
+        int16_t move_y = ps2_mouse_movement(mouse_report.buttons, y, PS2_MOUSE_Y_SIGN, PS2_MOUSE_Y_OVFLW) * PS2_MOUSE_Y_MULTIPLIER;
+#    ifdef PS2_MOUSE_INVERT_X
+        move_x = -move_x;
+#    endif
+#    ifndef PS2_MOUSE_INVERT_Y
+        move_y = -move_y;
+#    endif
+#endif
         ps2_mouse_convert_report_to_hid(&mouse_report);
 #if PS2_MOUSE_SCROLL_BTN_MASK
         ps2_mouse_scroll_button_task(&mouse_report);
@@ -102,7 +116,17 @@ void ps2_mouse_task(void) {
         // Used to debug the bytes sent to the host
         ps2_mouse_print_report(&mouse_report);
 #endif
-        host_mouse_send(&mouse_report);
+#ifdef MOUSE_ACCUMULATOR_ENABLE
+        // Scrolling takes the movement over
+        if (!mouse_report.x && !mouse_report.y) {
+            move_x = 0;
+            move_y = 0;
+        }
+        mouse_accumulator_move(move_x, move_y, mouse_report.v, mouse_report.h);
+        mouse_accumulator_buttons(MOUSE_SOURCE_PS2, mouse_report.buttons);
+#else
+        MOUSE_REPORT_SEND(MOUSE_SOURCE_PS2, &mouse_report);
+#endif
     }
 
     ps2_mouse_clear_report(&mouse_report);
@@ -231,7 +255,7 @@ static inline void ps2_mouse_scroll_button_task(report_mouse_t *mouse_report) {
 #if PS2_MOUSE_SCROLL_BTN_SEND
         if (scroll_state == SCROLL_BTN && timer_elapsed(scroll_button_time) < PS2_MOUSE_SCROLL_BTN_SEND) {
             PRESS_SCROLL_BUTTONS;
-            host_mouse_send(mouse_report);
+            MOUSE_REPORT_SEND(MOUSE_SOURCE_PS2, mouse_report);
             _delay_ms(100);
             RELEASE_SCROLL_BUTTONS;
         }
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PS2_MOUSE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "debug.h"
 
 #define PS2_MOUSE_SEND(command, message)                                                \
@@ -152,6 +153,16 @@ typedef enum ps2_mouse_sample_rate_e {
     PS2_MOUSE_200_SAMPLES_SEC = 200,
 } ps2_mouse_sample_rate_t;
 
+/* Movement on one axis as the whole 9-bit value (-256 to 255), from the
+ * status byte of the packet and the movement byte of that axis */
+static inline int16_t ps2_mouse_movement(uint8_t status, uint8_t value, uint8_t sign_bit, uint8_t overflow_bit) {
+    bool negative = status & (1 << sign_bit);
+    if (status & (1 << overflow_bit)) {
+        return negative ? -256 : 255;
+    }
+    return negative ? (int16_t)value - 256 : value;
+}
+
 void ps2_mouse_init(void);
 
 void ps2_mouse_init_user(void);